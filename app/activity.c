@@ -0,0 +1,128 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/activity.h"
+#include "driver/serial-flash.h"
+#include "radio/flash-ring.h"
+#include "radio/scheduler.h"
+
+// Two sectors of page sized log images, each flush programs the next page of the ring.
+#define ACTIVITY_ADDRESS        0x3E2000U
+#define ACTIVITY_SECTORS        2U
+#define ACTIVITY_SLOTS          (ACTIVITY_SECTORS * 0x1000U / sizeof(ActivityLog_t))
+#define ACTIVITY_MAGIC          0x31544341U // "ACT1"
+
+// A signal seen again within this many seconds belongs to the same transmission.
+#define ACTIVITY_HIT_GAP        5U
+#define ACTIVITY_FLUSH_INTERVAL 300U
+
+ActivityLog_t gActivityLog;
+
+static const FlashRing_t Ring = { ACTIVITY_ADDRESS, ACTIVITY_MAGIC, sizeof(ActivityLog_t), ACTIVITY_SLOTS };
+
+static uint32_t ClockBase;
+static uint32_t LastFlush;
+static uint8_t NextSlot;
+static bool bDirty;
+
+void ACTIVITY_Init(void)
+{
+	uint32_t Sequence;
+	const uint8_t Latest = FLASHRING_FindLatest(&Ring, &Sequence);
+
+	if (Latest < ACTIVITY_SLOTS) {
+		SFLASH_Read(&gActivityLog, FLASHRING_GetAddress(&Ring, Latest), sizeof(gActivityLog));
+		NextSlot = (Latest + 1) % ACTIVITY_SLOTS;
+	}
+	if (Latest == ACTIVITY_SLOTS || gActivityLog.Count > ACTIVITY_MAX_ENTRIES) {
+		gActivityLog.Magic = ACTIVITY_MAGIC;
+		gActivityLog.Sequence = 0;
+		gActivityLog.Clock = 0;
+		gActivityLog.Count = 0;
+		NextSlot = 0;
+	}
+
+	// Seconds keep counting from the last flush, so entries from several sessions stay ordered.
+	ClockBase = gActivityLog.Clock;
+	LastFlush = ClockBase;
+	bDirty = false;
+}
+
+uint32_t ACTIVITY_GetClock(void)
+{
+	return ClockBase + (gTimeSinceBoot / 1000U);
+}
+
+void ACTIVITY_Record(uint32_t Frequency, uint16_t Rssi, uint32_t Tolerance)
+{
+	const uint32_t Now = ACTIVITY_GetClock();
+	ActivityEntry_t *pEntry;
+	uint8_t i;
+
+	for (i = 0; i < gActivityLog.Count; i++) {
+		pEntry = &gActivityLog.Entries[i];
+		if (Frequency + Tolerance >= pEntry->Frequency && Frequency <= pEntry->Frequency + Tolerance) {
+			if (Now - pEntry->LastSeen >= ACTIVITY_HIT_GAP && pEntry->Hits < 0xFFFF) {
+				pEntry->Hits++;
+			}
+			pEntry->LastSeen = Now;
+			// Neighbouring bins are merged, the strongest one gives the frequency.
+			if (Rssi > pEntry->PeakRssi) {
+				pEntry->PeakRssi = Rssi;
+				pEntry->Frequency = Frequency;
+			}
+			bDirty = true;
+			return;
+		}
+	}
+
+	if (gActivityLog.Count < ACTIVITY_MAX_ENTRIES) {
+		pEntry = &gActivityLog.Entries[gActivityLog.Count++];
+	} else {
+		// Full, the entry that has been quiet the longest makes room.
+		pEntry = &gActivityLog.Entries[0];
+		for (i = 1; i < ACTIVITY_MAX_ENTRIES; i++) {
+			if (gActivityLog.Entries[i].LastSeen < pEntry->LastSeen) {
+				pEntry = &gActivityLog.Entries[i];
+			}
+		}
+	}
+
+	pEntry->Frequency = Frequency;
+	pEntry->FirstSeen = Now;
+	pEntry->LastSeen = Now;
+	pEntry->Hits = 1;
+	pEntry->PeakRssi = Rssi;
+	bDirty = true;
+}
+
+void ACTIVITY_Flush(bool bForce)
+{
+	const uint32_t Now = ACTIVITY_GetClock();
+
+	if (!bDirty || (!bForce && Now - LastFlush < ACTIVITY_FLUSH_INTERVAL)) {
+		return;
+	}
+
+	gActivityLog.Sequence++;
+	gActivityLog.Clock = Now;
+	FLASHRING_Write(&Ring, NextSlot, 0, &gActivityLog, sizeof(gActivityLog));
+
+	NextSlot = (NextSlot + 1) % ACTIVITY_SLOTS;
+	LastFlush = Now;
+	bDirty = false;
+}
+
@@ -0,0 +1,51 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_ACTIVITY_H
+#define APP_ACTIVITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ACTIVITY_MAX_ENTRIES 15
+
+typedef struct {
+	uint32_t Frequency;
+	uint32_t FirstSeen;
+	uint32_t LastSeen;
+	uint16_t Hits;
+	uint16_t PeakRssi;
+} ActivityEntry_t;
+
+// One log image is exactly one flash page, the same layout is returned by UART command 0x53.
+typedef struct {
+	uint32_t Magic;
+	uint32_t Sequence;
+	uint32_t Clock;
+	uint8_t Count;
+	uint8_t Reserved[3];
+	ActivityEntry_t Entries[ACTIVITY_MAX_ENTRIES];
+} ActivityLog_t;
+
+extern ActivityLog_t gActivityLog;
+
+void ACTIVITY_Init(void);
+uint32_t ACTIVITY_GetClock(void);
+void ACTIVITY_Record(uint32_t Frequency, uint16_t Rssi, uint32_t Tolerance);
+void ACTIVITY_Flush(bool bForce);
+
+#endif
+
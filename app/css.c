@@ -111,7 +111,7 @@ uint32_t CSS_CalculateGolay(uint32_t Code)
 	return Golay;
 }
 
-void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow)
+void CSS_GetCustomCode(CSS_Registers_t *pCss, bool bIs24Bit, uint16_t Code, bool bIsNarrow)
 {
 	uint16_t Gain = 0x8000;
 
@@ -123,29 +123,33 @@ void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow)
 	if (bIs24Bit) {
 		Gain |= 0x0800;
 	}
-	BK4819_WriteRegister(0x51, Gain);
-	BK4819_WriteRegister(0x07, 2775);
-	BK4819_WriteRegister(0x08, 0x0000 | ((Code >>  0) & 0xFFFU));
-	BK4819_WriteRegister(0x08, 0x8000 | ((Code >> 12) & 0xFFFU));
+	pCss->Control = Gain;
+	pCss->Frequency = 2775;
+	pCss->Code[0] = 0x0000 | ((Code >>  0) & 0xFFFU);
+	pCss->Code[1] = 0x8000 | ((Code >> 12) & 0xFFFU);
 }
 
-void CSS_SetStandardCode(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bNarrow)
+void CSS_GetStandardCode(CSS_Registers_t *pCss, uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bNarrow)
 {
 	uint16_t Enable;
 	uint32_t Golay;
 
+	pCss->Control = 0x0000;
+	pCss->Frequency = 0;
+	pCss->Code[0] = 0;
+	pCss->Code[1] = 0;
+
 	switch (CodeType) {
 	case CODE_TYPE_CTCSS:
 		if (bNarrow) {
-			BK4819_WriteRegister(0x51, gFrequencyBandInfo.CtcssTxGainNarrow | 0x9000);
+			pCss->Control = gFrequencyBandInfo.CtcssTxGainNarrow | 0x9000;
 		} else {
-			BK4819_WriteRegister(0x51, gFrequencyBandInfo.CtcssTxGainWide | 0x9000);
+			pCss->Control = gFrequencyBandInfo.CtcssTxGainWide | 0x9000;
 		}
-		BK4819_WriteRegister(0x07, ((Code * 413) / 200) & 0x1FFF);
+		pCss->Frequency = ((Code * 413) / 200) & 0x1FFF;
 		break;
 
 	case CODE_TYPE_OFF:
-		BK4819_WriteRegister(0x51, 0x0000);
 		break;
 
 	case CODE_TYPE_DCS_N:
@@ -161,16 +165,44 @@ void CSS_SetStandardCode(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool
 			Enable = 0x8000;
 		}
 		if (bNarrow) {
-			BK4819_WriteRegister(0x51, Enable | gFrequencyBandInfo.DcsTxGainNarrow);
+			pCss->Control = Enable | gFrequencyBandInfo.DcsTxGainNarrow;
 		} else {
-			BK4819_WriteRegister(0x51, Enable | gFrequencyBandInfo.DcsTxGainWide);
+			pCss->Control = Enable | gFrequencyBandInfo.DcsTxGainWide;
 		}
-		BK4819_WriteRegister(0x07, 2775);
-		BK4819_WriteRegister(0x08, 0x0000 | ((Golay >>  0) & 0xFFFU));
-		BK4819_WriteRegister(0x08, 0x8000 | ((Golay >> 12) & 0xFFFU));
+		pCss->Frequency = 2775;
+		pCss->Code[0] = 0x0000 | ((Golay >>  0) & 0xFFFU);
+		pCss->Code[1] = 0x8000 | ((Golay >> 12) & 0xFFFU);
 	}
 }
 
+void CSS_SetRegisters(const CSS_Registers_t *pCss)
+{
+	BK4819_WriteRegister(0x51, pCss->Control);
+	if (pCss->Control) {
+		BK4819_WriteRegister(0x07, pCss->Frequency);
+	}
+	if (pCss->Code[1]) {
+		BK4819_WriteRegister(0x08, pCss->Code[0]);
+		BK4819_WriteRegister(0x08, pCss->Code[1]);
+	}
+}
+
+void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow)
+{
+	CSS_Registers_t Css;
+
+	CSS_GetCustomCode(&Css, bIs24Bit, Code, bIsNarrow);
+	CSS_SetRegisters(&Css);
+}
+
+void CSS_SetStandardCode(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bNarrow)
+{
+	CSS_Registers_t Css;
+
+	CSS_GetStandardCode(&Css, CodeType, Code, Encrypt, bNarrow);
+	CSS_SetRegisters(&Css);
+}
+
 uint16_t CSS_ConvertCode(uint16_t Code)
 {
 	return (Code & 7) + (((Code >> 6) & 7) * 10 + ((Code >> 3) & 7)) * 10;
@@ -27,7 +27,16 @@ enum {
 	CODE_TYPE_OFF,
 };
 
+typedef struct {
+	uint16_t Control;	// 0x51
+	uint16_t Frequency;	// 0x07
+	uint16_t Code[2];	// 0x08 low and high word, Code[1] is 0 when no DCS code is set
+} CSS_Registers_t;
+
 uint32_t CSS_CalculateGolay(uint32_t Code);
+void CSS_GetCustomCode(CSS_Registers_t *pCss, bool bIs24Bit, uint16_t Code, bool bIsNarrow);
+void CSS_GetStandardCode(CSS_Registers_t *pCss, uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bNarrow);
+void CSS_SetRegisters(const CSS_Registers_t *pCss);
 void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow);
 void CSS_SetStandardCode(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bNarrow);
 uint16_t CSS_ConvertCode(uint16_t Code);
@@ -15,6 +15,7 @@
  */
 
 #include "app/lock.h"
+#include "misc.h"
 #include "radio/settings.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
@@ -22,7 +23,10 @@
 void LOCK_Toggle(void)
 {
 	gSettings.Lock ^= 1;
-	UI_DrawStatusIcon(4, ICON_LOCK, gSettings.Lock, COLOR_FOREGROUND);
+	// The spectrum has no status bar, the icon is drawn with the main screen on exit
+	if (!gSpectrumMode) {
+		UI_DrawStatusIcon(4, ICON_LOCK, gSettings.Lock, COLOR_FOREGROUND);
+	}
 	SETTINGS_SaveGlobals();
 }
 
@@ -26,7 +26,9 @@
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "misc.h"
+#include "radio/channels.h"
 #include "radio/hardware.h"
+#include "radio/lockout.h"
 #include "radio/settings.h"
 #include "task/cursor.h"
 #include "task/keyaction.h"
@@ -47,6 +49,8 @@ static const char Menu[][14] = {
 	"Roger Beep    ",
 	"Dual Display  ",
 	"TX Priority   ",
+	"Watch Time    ",
+	"Spectrum Watch",
 	"Save Mode     ",
 	"Freq Step     ",
 	"SQ Level      ",
@@ -63,6 +67,12 @@ static const char Menu[][14] = {
 	"Repeater Mode ",
 	"Scan Resume   ",
 	"Scan Blink    ",
+	"Scan Rate     ",
+	"Priority Scan ",
+	"Active First  ",
+	"Lockout Time  ",
+	"Keep Lockouts ",
+	"Band Scan     ",
 	"CTCSS/DCS     ",
 	"RX CTCSS/DCS  ",
 	"TX CTCSS/DCS  ",
@@ -144,6 +154,7 @@ static uint16_t gSettingCurrentValue;
 static uint8_t gSettingCodeType;
 static uint16_t gSettingCode;
 static uint8_t EditSize;
+static uint8_t gSettingScanLists;
 
 uint16_t gSettingGolay;
 
@@ -303,6 +314,18 @@ static void CHANNEL_KeyHandler(KEY_t Key)
 	}
 }
 
+// Keys 1 to 8 add or remove a list of the merged scan and select it.
+static void SCANLIST_KeyHandler(uint8_t Key)
+{
+	if (Key >= KEY_1 && Key <= KEY_8) {
+		gSettingScanLists ^= 1U << (Key - KEY_1);
+		gSettingCurrentValue = 9;
+		gSettingIndex = 0;
+		UI_DrawSettingArrow(0);
+		UI_DrawSettingScanlist(gSettingCurrentValue, gSettingScanLists);
+	}
+}
+
 static void MUTE_KeyHandler(uint8_t Key)
 {
 	if (Key < 10) {
@@ -396,6 +419,11 @@ void MENU_AcceptSetting(void)
 		SETTINGS_SaveGlobals();
 		break;
 
+	case MENU_WATCH_TIME:
+		gExtendedSettings.WatchTime = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues;
+		SETTINGS_SaveGlobals();
+		break;
+
 	case MENU_SAVE_MODE:
 		gSettings.SaveMode = gSettingIndex;
 		SETTINGS_SaveGlobals();
@@ -480,6 +508,54 @@ void MENU_AcceptSetting(void)
 		SETTINGS_SaveGlobals();
 		break;
 
+	case MENU_SCAN_RATE:
+		gExtendedSettings.ScanRate = ((gSettingCurrentValue + gSettingIndex) % gSettingMaxValues) ^ 5U;
+		SETTINGS_SaveGlobals();
+		break;
+
+	case MENU_PRIORITY_SCAN:
+		gExtendedSettings.PriorityScanOff = !gSettingIndex;
+		SETTINGS_SaveGlobals();
+		break;
+
+	case MENU_ACTIVE_FIRST:
+		gExtendedSettings.ScanActiveFirstOff = !gSettingIndex;
+		SETTINGS_SaveGlobals();
+		break;
+
+	case MENU_LOCKOUT_TIME:
+		gExtendedSettings.LockoutTime = ((gSettingCurrentValue + gSettingIndex) % gSettingMaxValues) ^ 7U;
+		SETTINGS_SaveGlobals();
+		LOCKOUT_Clear();
+		break;
+
+#ifdef ENABLE_SPECTRUM_WATCH
+	case MENU_SPECTRUM_WATCH:
+		gExtendedSettings.SpectrumWatchOff = !gSettingIndex;
+		SETTINGS_SaveGlobals();
+		break;
+#endif
+
+	case MENU_LOCKOUT_KEEP:
+		gExtendedSettings.LockoutKeepOff = !gSettingIndex;
+		SETTINGS_SaveGlobals();
+		LOCKOUT_Save();
+		break;
+
+	case MENU_BAND_SCAN:
+		// The limits are taken from the two VFOs, the step from the current one
+		gExtendedSettings.BandScan = gSettingIndex;
+		if (gSettingIndex) {
+			const uint32_t A = gVfoState[0].RX.Frequency;
+			const uint32_t B = gVfoState[1].RX.Frequency;
+
+			gExtendedSettings.BandScanLower = A < B ? A : B;
+			gExtendedSettings.BandScanUpper = A < B ? B : A;
+			gExtendedSettings.BandScanStep = gSettings.FrequencyStep;
+		}
+		SETTINGS_SaveGlobals();
+		break;
+
 	case MENU_CTCSS_DCS:
 		gVfoState[gSettings.CurrentVfo].TX.CodeType = gSettingCodeType;
 		gVfoState[gSettings.CurrentVfo].TX.Code = gSettingCode;
@@ -517,7 +593,9 @@ void MENU_AcceptSetting(void)
 
 	case MENU_LIST_TO_SCAN:
 		gExtendedSettings.ScanAll = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues == 8;
-		if (!gExtendedSettings.ScanAll) {
+		gExtendedSettings.ScanMerged = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues == 9;
+		gExtendedSettings.ScanListSkip = ~gSettingScanLists;
+		if (!gExtendedSettings.ScanAll && !gExtendedSettings.ScanMerged) {
 			gExtendedSettings.CurrentScanList = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues;
 		}
 		SETTINGS_SaveGlobals();
@@ -757,6 +835,13 @@ void MENU_DrawSetting(void)
 		UI_DrawTxPriority();
 		break;
 
+	case MENU_WATCH_TIME:
+		gSettingCurrentValue = gExtendedSettings.WatchTime;
+		gSettingMaxValues = 8;
+		DISPLAY_Fill(0, 159, 1, 55, COLOR_BACKGROUND);
+		UI_DrawSettingWatchTime(gSettingCurrentValue);
+		break;
+
 	case MENU_SAVE_MODE:
 		gSettingIndex = gSettings.SaveMode;
 		UI_DrawToggle();
@@ -865,6 +950,47 @@ void MENU_DrawSetting(void)
 		UI_DrawToggle();
 		break;
 
+	case MENU_SCAN_RATE:
+		gSettingCurrentValue = gExtendedSettings.ScanRate ^ 5U;
+		gSettingMaxValues = 8;
+		DISPLAY_Fill(0, 159, 1, 55, COLOR_BACKGROUND);
+		UI_DrawSettingScanRate(gSettingCurrentValue);
+		break;
+
+	case MENU_PRIORITY_SCAN:
+		gSettingIndex = !gExtendedSettings.PriorityScanOff;
+		UI_DrawToggle();
+		break;
+
+	case MENU_ACTIVE_FIRST:
+		gSettingIndex = !gExtendedSettings.ScanActiveFirstOff;
+		UI_DrawToggle();
+		break;
+
+	case MENU_LOCKOUT_TIME:
+		gSettingCurrentValue = gExtendedSettings.LockoutTime ^ 7U;
+		gSettingMaxValues = 8;
+		DISPLAY_Fill(0, 159, 1, 55, COLOR_BACKGROUND);
+		UI_DrawSettingLockoutTime(gSettingCurrentValue);
+		break;
+
+	case MENU_LOCKOUT_KEEP:
+		gSettingIndex = !gExtendedSettings.LockoutKeepOff;
+		UI_DrawToggle();
+		break;
+
+#ifdef ENABLE_SPECTRUM_WATCH
+	case MENU_SPECTRUM_WATCH:
+		gSettingIndex = !gExtendedSettings.SpectrumWatchOff;
+		UI_DrawToggle();
+		break;
+#endif
+
+	case MENU_BAND_SCAN:
+		gSettingIndex = gExtendedSettings.BandScan && gExtendedSettings.BandScanLower < gExtendedSettings.BandScanUpper;
+		UI_DrawToggle();
+		break;
+
 	case MENU_CTCSS_DCS:
 	case MENU_RX_CTCSS_DCS:
 		gSettingCode = gVfoState[gSettings.CurrentVfo].RX.Code;
@@ -906,10 +1032,11 @@ void MENU_DrawSetting(void)
 		break;
 
 	case MENU_LIST_TO_SCAN:
-		gSettingCurrentValue = gExtendedSettings.ScanAll ? 8 : gExtendedSettings.CurrentScanList;
-		gSettingMaxValues = 9;
+		gSettingScanLists = ~gExtendedSettings.ScanListSkip;
+		gSettingCurrentValue = gExtendedSettings.ScanAll ? 8 : CHANNELS_IsScanMerged() ? 9 : gExtendedSettings.CurrentScanList;
+		gSettingMaxValues = 10;
 		DISPLAY_Fill(0, 159, 1, 55, COLOR_BACKGROUND);
-		UI_DrawSettingScanlist(gSettingCurrentValue);
+		UI_DrawSettingScanlist(gSettingCurrentValue, gSettingScanLists);
 		break;
 
 	case MENU_SCANLIST_1:
@@ -1146,6 +1273,9 @@ void MENU_SettingKeyHandler(uint8_t Key)
 					|| gMenuIndex == MENU_RX_CTCSS_DCS
 					|| gMenuIndex == MENU_TX_CTCSS_DCS
 					|| gMenuIndex == MENU_SCAN_RESUME
+					|| gMenuIndex == MENU_SCAN_RATE
+					|| gMenuIndex == MENU_LOCKOUT_TIME
+					|| gMenuIndex == MENU_WATCH_TIME
 					|| gMenuIndex == MENU_SAVE_CH
 					|| gMenuIndex == MENU_DELETE_CH) {
 				MENU_Redraw(true);
@@ -1179,6 +1309,10 @@ void MENU_SettingKeyHandler(uint8_t Key)
 			CSS_KeyHandler(Key);
 			break;
 
+		case MENU_LIST_TO_SCAN:
+			SCANLIST_KeyHandler(Key);
+			break;
+
 		case MENU_MUTE_CODE:
 			MUTE_KeyHandler(Key);
 			break;
@@ -1267,6 +1401,18 @@ void MENU_ScrollSetting(uint8_t Key)
 		UI_DrawSettingScanResume(gSettingCurrentValue);
 		break;
 
+	case MENU_SCAN_RATE:
+		UI_DrawSettingScanRate(gSettingCurrentValue);
+		break;
+
+	case MENU_LOCKOUT_TIME:
+		UI_DrawSettingLockoutTime(gSettingCurrentValue);
+		break;
+
+	case MENU_WATCH_TIME:
+		UI_DrawSettingWatchTime(gSettingCurrentValue);
+		break;
+
 	case MENU_TX_POWER:
 		UI_DrawSettingTxPower();
 		break;
@@ -1280,7 +1426,7 @@ void MENU_ScrollSetting(uint8_t Key)
 		break;
 
 	case MENU_LIST_TO_SCAN:
-		UI_DrawSettingScanlist(gSettingCurrentValue);
+		UI_DrawSettingScanlist(gSettingCurrentValue, gSettingScanLists);
 		break;
 
 	case MENU_BUSY_LOCK:
@@ -30,6 +30,8 @@ enum {
 	MENU_ROGER_BEEP,
 	MENU_DUAL_DISPLAY,
 	MENU_TX_PRIORITY,
+	MENU_WATCH_TIME,
+	MENU_SPECTRUM_WATCH,
 	MENU_SAVE_MODE,
 	MENU_FREQ_STEP,
 	MENU_SQ_LEVEL,
@@ -46,6 +48,12 @@ enum {
 	MENU_REPEATER_MODE,
 	MENU_SCAN_RESUME,
 	MENU_SCAN_BLINK,
+	MENU_SCAN_RATE,
+	MENU_PRIORITY_SCAN,
+	MENU_ACTIVE_FIRST,
+	MENU_LOCKOUT_TIME,
+	MENU_LOCKOUT_KEEP,
+	MENU_BAND_SCAN,
 	MENU_CTCSS_DCS,
 	MENU_RX_CTCSS_DCS,
 	MENU_TX_CTCSS_DCS,
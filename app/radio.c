@@ -14,6 +14,7 @@
  *     limitations under the License.
  */
 
+#include <string.h>
 #include "app/css.h"
 #include "app/fm.h"
 #include "app/radio.h"
@@ -31,6 +32,7 @@
 #include "radio/data.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/stats.h"
 #include "task/alarm.h"
 #ifdef ENABLE_NOAA
 	#include "task/noaa.h"
@@ -55,6 +57,41 @@ uint16_t gCurrentRssi[2];
 bool gNoaaMode;
 uint16_t gCode;
 
+// Tune descriptors of the channels visited by the scanner, filled on the first visit of each
+// channel and replayed by later hops. An entry is only replayed while its band is the current
+// one, so gFrequencyBandInfo stays valid for the audio path.
+#define SCAN_TUNE_COUNT	8
+
+typedef struct {
+	uint16_t Channel;
+	uint8_t Band;
+	RADIO_FastTune_t Tune;
+} ScanTune_t;
+
+static ScanTune_t ScanTunes[SCAN_TUNE_COUNT];
+static uint8_t ScanTuneCount;
+static uint8_t ScanTuneNext;
+static uint8_t ScanTuneSquelch;
+static uint8_t ScanTuneRepeaterMode;
+static uint16_t BandScanLevel = 0xFFFF;
+
+// Dual watch keeps the register values of both VFOs, so a switch only writes what differs from
+// the VFO the receiver is on and skips the RX enable delay. A VFO is tuned in full again when its
+// settings, the squelch level or the repeater mode change, and after anything else retuned the
+// receiver.
+#define WATCH_NONE	0xFF
+
+typedef struct {
+	ChannelInfo_t Vfo;	// what Tune was prepared from
+	RADIO_FastTune_t Tune;
+	bool bValid;
+} WatchTune_t;
+
+static WatchTune_t WatchTunes[2];
+static uint8_t WatchTuned = WATCH_NONE;
+static uint8_t WatchSquelch;
+static uint8_t WatchRepeaterMode;
+
 static void EnableTxAmp(bool bEnable)
 {
 	if (!bEnable) {
@@ -69,7 +106,7 @@ static void EnableTxAmp(bool bEnable)
 	}
 }
 
-static void TuneCurrentVfo(void)
+static void SetVfoInfo(void)
 {
 	if (gSettings.RepeaterMode == 2) {
 		// Frequency reversal
@@ -89,6 +126,12 @@ static void TuneCurrentVfo(void)
 		gVfoInfo[gCurrentVfo]  = gMainVfo->RX;
 		gVfoInfo[!gCurrentVfo] = gVfoState[!gCurrentVfo].RX;
 	}
+}
+
+static void TuneCurrentVfo(void)
+{
+	SetVfoInfo();
+	BandScanLevel = 0xFFFF;
 
 	if (!gScannerMode) {
 		gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
@@ -206,6 +249,11 @@ static void TuneNOAA(void)
 
 void RADIO_Init(void)
 {
+#ifdef UART_DEBUG
+	uint32_t BootTime[5];
+	bool bIndexRebuilt;
+#endif
+
 	if (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1)) {
 		if (KEY_GetButton() == KEY_1) {
 			UART_Init(19200);
@@ -218,8 +266,14 @@ void RADIO_Init(void)
 		}
 	}
 
+#ifdef UART_DEBUG
+	BootTime[0] = gTimeSinceBoot;
+#endif
 	SETTINGS_LoadCalibration();
 	SETTINGS_LoadSettings();
+#ifdef UART_DEBUG
+	BootTime[1] = gTimeSinceBoot;
+#endif
 
 	BK4819_Init();
 	#ifdef ENABLE_AM_FIX
@@ -230,6 +284,13 @@ void RADIO_Init(void)
 		UI_DrawBoot();
 	}
 
+#ifdef UART_DEBUG
+	BootTime[2] = gTimeSinceBoot;
+	bIndexRebuilt = CHANNELS_BuildIndex();
+	BootTime[3] = gTimeSinceBoot;
+#else
+	CHANNELS_BuildIndex();
+#endif
 	CHANNELS_CheckFreeChannels();
 
 	if (gSettings.WorkMode) {
@@ -237,6 +298,15 @@ void RADIO_Init(void)
 	} else {
 		CHANNELS_LoadVfoMode();
 	}
+#ifdef UART_DEBUG
+	BootTime[4] = gTimeSinceBoot;
+	UART_printf("Boot: settings %lu ms, radio and logo %lu ms, channel index %lu ms (%s), channels %lu ms\r\n",
+		(unsigned long)(BootTime[1] - BootTime[0]),
+		(unsigned long)(BootTime[2] - BootTime[1]),
+		(unsigned long)(BootTime[3] - BootTime[2]),
+		bIndexRebuilt ? "rebuilt" : "loaded",
+		(unsigned long)(BootTime[4] - BootTime[3]));
+#endif
 
 	gCurrentVfo = gSettings.CurrentVfo;
 
@@ -257,6 +327,7 @@ void RADIO_Init(void)
 
 void RADIO_Tune(uint8_t Vfo)
 {
+	WatchTuned = WATCH_NONE;
 	gMainVfo = &gVfoState[Vfo];
 	if (Vfo != 2) {
 		gNoaaMode = false;
@@ -267,11 +338,235 @@ void RADIO_Tune(uint8_t Vfo)
 	}
 }
 
+static uint8_t FindScanTune(uint16_t Channel)
+{
+	uint8_t i;
+
+	if (ScanTuneSquelch != gSettings.Squelch || ScanTuneRepeaterMode != gSettings.RepeaterMode) {
+		RADIO_ClearScanTunes();
+		ScanTuneSquelch = gSettings.Squelch;
+		ScanTuneRepeaterMode = gSettings.RepeaterMode;
+	}
+
+	for (i = 0; i < ScanTuneCount && ScanTunes[i].Channel != Channel; i++) {
+	}
+
+	return i;
+}
+
+// Same as RADIO_Tune() for a scanner hop to the memory channel of Vfo, without the band lookup
+// and the RX enable delay once the channel has been visited or staged.
+void RADIO_ScanTune(uint8_t Vfo)
+{
+	const uint16_t Channel = gSettings.VfoChNo[Vfo];
+	const uint8_t i = FindScanTune(Channel);
+
+	if (i < ScanTuneCount && ScanTunes[i].Band == gCurrentFrequencyBand) {
+		gMainVfo = &gVfoState[Vfo];
+		gNoaaMode = false;
+		gCurrentVfo = Vfo;
+		SetVfoInfo();
+		gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+		gRadioMode = RADIO_MODE_QUIET;
+		EnableTxAmp(false);
+		gCode = gVfoInfo[gCurrentVfo].Code;
+		RADIO_FastTune(&ScanTunes[i].Tune);
+		return;
+	}
+
+	RADIO_Tune(Vfo);
+	if (i == ScanTuneCount && ScanTuneCount < SCAN_TUNE_COUNT) {
+		ScanTunes[i].Channel = Channel;
+		ScanTunes[i].Band = gCurrentFrequencyBand;
+		RADIO_PrepareFastTune(&gVfoState[Vfo], &ScanTunes[i].Tune);
+		ScanTuneCount++;
+	}
+}
+
+// Prepares the descriptor of a channel ahead of its hop, replacing the oldest staged one when
+// the table is full. Only channels in the band of the current one are kept, RADIO_ScanTune()
+// cannot replay the others.
+void RADIO_StageScanTune(uint16_t Channel, const ChannelInfo_t *pInfo)
+{
+	const uint8_t Band = gCurrentFrequencyBand;
+	uint8_t i = FindScanTune(Channel);
+	RADIO_FastTune_t Tune;
+	uint8_t TuneBand;
+
+	if (i < ScanTuneCount) {
+		return;
+	}
+	RADIO_PrepareFastTune(pInfo, &Tune);
+	TuneBand = gCurrentFrequencyBand;
+	// Puts the band and squelch levels of the current frequency back
+	FREQUENCY_SelectBand(gVfoInfo[gCurrentVfo].Frequency);
+	if (TuneBand != Band) {
+		return;
+	}
+
+	if (i == SCAN_TUNE_COUNT) {
+		i = ScanTuneNext;
+		ScanTuneNext = (ScanTuneNext + 1) % SCAN_TUNE_COUNT;
+	} else {
+		ScanTuneCount++;
+	}
+	ScanTunes[i].Channel = Channel;
+	ScanTunes[i].Band = Band;
+	ScanTunes[i].Tune = Tune;
+}
+
+void RADIO_ClearScanTunes(void)
+{
+	ScanTuneCount = 0;
+	ScanTuneNext = 0;
+}
+
+// Same as RADIO_Tune() for a band scan hop of Vfo. While the band stays the same only the
+// frequency is written and the VCO recalibrated, the squelch thresholds follow the calibration
+// levels every 5 MHz.
+void RADIO_BandScanTune(uint8_t Vfo)
+{
+	const uint8_t Band = gCurrentFrequencyBand;
+	const uint32_t Frequency = gVfoState[Vfo].RX.Frequency;
+	BK4819_Squelch_t Squelch;
+
+	if (gNoaaMode || gCurrentVfo != Vfo || gMainVfo != &gVfoState[Vfo]) {
+		RADIO_Tune(Vfo);
+		return;
+	}
+	FREQUENCY_SelectBand(Frequency);
+	if (gCurrentFrequencyBand != Band) {
+		RADIO_Tune(Vfo);
+		return;
+	}
+
+	WatchTuned = WATCH_NONE;
+	SetVfoInfo();
+	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+	gRadioMode = RADIO_MODE_QUIET;
+	EnableTxAmp(false);
+	BK4819_set_rf_frequency((gVfoInfo[gCurrentVfo].Frequency - 32768U) + gFrequencyBandInfo.FrequencyOffset, true);
+	if (BandScanLevel != Frequency / 500000U) {
+		BandScanLevel = Frequency / 500000U;
+		BK4819_GetSquelch(&Squelch, gMainVfo->bIsNarrow);
+		BK4819_SetSquelch(&Squelch);
+	}
+}
+
+// Follows the RX half of TuneCurrentVfo(). The band lookup may read the calibration from flash,
+// so this belongs outside of any time critical loop.
+void RADIO_PrepareFastTune(const ChannelInfo_t *pVfo, RADIO_FastTune_t *pTune)
+{
+	FrequencyInfo_t Info;
+
+	if (gSettings.RepeaterMode == 2) {
+		Info = pVfo->TX;
+	} else {
+		Info = pVfo->RX;
+		if (gSettings.RepeaterMode == 1) {
+			Info.CodeType = CODE_TYPE_OFF;
+			Info.Code = 0;
+		}
+	}
+
+	FREQUENCY_SelectBand(Info.Frequency);
+	pTune->Frequency = (Info.Frequency - 32768U) + gFrequencyBandInfo.FrequencyOffset;
+	pTune->bUseUhfFilter = gUseUhfFilter;
+	if (pVfo->bMuteEnabled) {
+		CSS_GetCustomCode(&pTune->Css, pVfo->bIs24Bit, pVfo->Golay, pVfo->bIsNarrow);
+	} else {
+		CSS_GetStandardCode(&pTune->Css, Info.CodeType, Info.Code, pVfo->Encrypt, pVfo->bIsNarrow);
+	}
+	BK4819_GetSquelch(&pTune->Squelch, pVfo->bIsNarrow);
+	pTune->Bandwidth = 0;
+	if (pVfo->gModulationType == 0) {
+		pTune->Bandwidth = pVfo->bIsNarrow ? 0x4048 : 0x3028;
+	}
+}
+
+// Expects the receiver to be enabled already. gFrequencyBandInfo is left alone, so a full
+// RADIO_Tune() is still needed before audio or TX.
+void RADIO_FastTune(const RADIO_FastTune_t *pTune)
+{
+	WatchTuned = WATCH_NONE;
+	BK4819_set_rf_frequency(pTune->Frequency, true);
+	CSS_SetRegisters(&pTune->Css);
+	BK4819_SetSquelch(&pTune->Squelch);
+	if (pTune->Bandwidth) {
+		BK4819_WriteRegister(0x43, pTune->Bandwidth);
+	}
+	gUseUhfFilter = pTune->bUseUhfFilter;
+	BK4819_EnableFilter(true);
+}
+
+// Writes pTune over the registers of pFrom, the frequency is always written to recalibrate the VCO.
+static void WriteTuneDelta(const RADIO_FastTune_t *pTune, const RADIO_FastTune_t *pFrom)
+{
+	BK4819_set_rf_frequency(pTune->Frequency, true);
+	if (memcmp(&pTune->Css, &pFrom->Css, sizeof(pTune->Css))) {
+		CSS_SetRegisters(&pTune->Css);
+	}
+	if (memcmp(&pTune->Squelch, &pFrom->Squelch, sizeof(pTune->Squelch))) {
+		BK4819_SetSquelch(&pTune->Squelch);
+	}
+	if (pTune->Bandwidth && pTune->Bandwidth != pFrom->Bandwidth) {
+		BK4819_WriteRegister(0x43, pTune->Bandwidth);
+	}
+	if (pTune->bUseUhfFilter != pFrom->bUseUhfFilter) {
+		gUseUhfFilter = pTune->bUseUhfFilter;
+		BK4819_EnableFilter(true);
+	}
+}
+
+// Same as RADIO_Tune() for a dual watch switch. Returns true when only the registers that differ
+// from the other VFO were written.
+bool RADIO_WatchTune(uint8_t Vfo)
+{
+	WatchTune_t *pWatch = &WatchTunes[Vfo];
+
+	if (WatchSquelch != gSettings.Squelch || WatchRepeaterMode != gSettings.RepeaterMode) {
+		WatchTunes[0].bValid = false;
+		WatchTunes[1].bValid = false;
+		WatchTuned = WATCH_NONE;
+		WatchSquelch = gSettings.Squelch;
+		WatchRepeaterMode = gSettings.RepeaterMode;
+	}
+
+	if (WatchTuned == WATCH_NONE || !pWatch->bValid || memcmp(&pWatch->Vfo, &gVfoState[Vfo], sizeof(pWatch->Vfo))) {
+		RADIO_Tune(Vfo);
+		pWatch->Vfo = gVfoState[Vfo];
+		RADIO_PrepareFastTune(&gVfoState[Vfo], &pWatch->Tune);
+		pWatch->bValid = true;
+		WatchTuned = Vfo;
+		return false;
+	}
+
+	gMainVfo = &gVfoState[Vfo];
+	gNoaaMode = false;
+	gCurrentVfo = Vfo;
+	SetVfoInfo();
+	BandScanLevel = 0xFFFF;
+	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
+	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+	gRadioMode = RADIO_MODE_QUIET;
+	EnableTxAmp(false);
+	gCode = gVfoInfo[gCurrentVfo].Code;
+	// Only reads the flash on a band change, the audio and TX paths need the band of this VFO
+	FREQUENCY_SelectBand(gVfoInfo[gCurrentVfo].Frequency);
+	WriteTuneDelta(&pWatch->Tune, &WatchTunes[WatchTuned].Tune);
+	WatchTuned = Vfo;
+
+	return true;
+}
+
 void RADIO_StartRX(void)
 {
 	FM_Disable(FM_MODE_STANDBY);
 	BK4819_StartAudio();
 	if (!gFrequencyDetectMode) {
+		if (gSettings.WorkMode) {
+			STATS_StartRX(gSettings.VfoChNo[gCurrentVfo]);
+		}
 		DTMF_ClearString();
 		DTMF_FSK_InitReceive(0);
 		VOX_Timer = 0;
@@ -311,6 +606,8 @@ void RADIO_EndRX(void)
 	BK4819_EnableFFSK1200(false);
 	BK4819_ResetFSK();
 	DTMF_Disable();
+	STATS_EndRX();
+	STATS_Flush(false);
 	if (gScannerMode) {
 		switch (gExtendedSettings.ScanResume) {
 			case 1:		// Carrier Operated
@@ -17,9 +17,20 @@
 #ifndef APP_RADIO_H
 #define APP_RADIO_H
 
+#include "app/css.h"
+#include "driver/bk4819.h"
 #include "radio/channels.h"
 #include "radio/frequencies.h"
 
+// Register values of a VFO, replayed by RADIO_FastTune() without the band lookup and the RX enable delay.
+typedef struct {
+	uint32_t Frequency;	// 0x38/0x39 with the band offset applied
+	CSS_Registers_t Css;
+	BK4819_Squelch_t Squelch;
+	uint16_t Bandwidth;	// 0x43, 0 when the modulation keeps the current filter
+	bool bUseUhfFilter;
+} RADIO_FastTune_t;
+
 extern uint8_t gCurrentVfo;
 extern ChannelInfo_t *gMainVfo;
 extern ChannelInfo_t gVfoState[3];
@@ -31,6 +42,13 @@ extern uint16_t gCode;
 
 void RADIO_Init(void);
 void RADIO_Tune(uint8_t Vfo);
+void RADIO_PrepareFastTune(const ChannelInfo_t *pVfo, RADIO_FastTune_t *pTune);
+void RADIO_FastTune(const RADIO_FastTune_t *pTune);
+void RADIO_ScanTune(uint8_t Vfo);
+void RADIO_StageScanTune(uint16_t Channel, const ChannelInfo_t *pInfo);
+void RADIO_ClearScanTunes(void);
+void RADIO_BandScanTune(uint8_t Vfo);
+bool RADIO_WatchTune(uint8_t Vfo);
 
 void RADIO_StartRX(void);
 void RADIO_EndRX(void);
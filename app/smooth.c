@@ -0,0 +1,99 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "app/smooth.h"
+
+// The Cortex-M4 build works on the samples as packed pairs: one 32-bit load and one 32-bit store
+// per two outputs, each output being three dual 16-bit multiply-accumulates of three adjacent
+// pairs. The host tests build that path with SMOOTH_DSP and C models of the instructions.
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	#include <at32f421.h>
+	#define SMOOTH_DSP
+#endif
+
+#ifdef SMOOTH_DSP
+// Weights of the pairs x-2/x-1, x/x+1 and x+2/x+3 for the even sample, the bottom halves
+#define SMOOTH_EVEN0	((SMOOTH_WEIGHT_NEAR << 16) | SMOOTH_WEIGHT_FAR)
+#define SMOOTH_EVEN1	((SMOOTH_WEIGHT_NEAR << 16) | SMOOTH_WEIGHT_CENTER)
+#define SMOOTH_EVEN2	(SMOOTH_WEIGHT_FAR)
+// and for the odd one after it
+#define SMOOTH_ODD0	(SMOOTH_WEIGHT_FAR << 16)
+#define SMOOTH_ODD1	((SMOOTH_WEIGHT_CENTER << 16) | SMOOTH_WEIGHT_NEAR)
+#define SMOOTH_ODD2	((SMOOTH_WEIGHT_FAR << 16) | SMOOTH_WEIGHT_NEAR)
+
+// The pair at Index, the samples past the end repeat the last one
+static uint32_t LoadPair(const uint16_t *pPixels, uint8_t Index, uint8_t Count)
+{
+	if (Index + 1 < Count) {
+		return __UNALIGNED_UINT32_READ(pPixels + Index);
+	}
+	if (Index < Count) {
+		return pPixels[Index] * 0x10001U;
+	}
+
+	return pPixels[Count - 1] * 0x10001U;
+}
+
+void SMOOTH_Trace(uint16_t *pPixels, uint8_t Count)
+{
+	uint32_t Pair0 = pPixels[0] * 0x10001U;
+	uint32_t Pair1 = LoadPair(pPixels, 0, Count);
+	uint32_t Pair2;
+	uint32_t Even;
+	uint32_t Odd;
+	uint8_t i;
+
+	// The next pair is read before the outputs overwrite the current one
+	for (i = 0; i + 1 < Count; i += 2) {
+		Pair2 = LoadPair(pPixels, i + 2, Count);
+		Even = __SMLAD(Pair0, SMOOTH_EVEN0, __SMLAD(Pair1, SMOOTH_EVEN1, __SMLAD(Pair2, SMOOTH_EVEN2, 128)));
+		Odd = __SMLAD(Pair0, SMOOTH_ODD0, __SMLAD(Pair1, SMOOTH_ODD1, __SMLAD(Pair2, SMOOTH_ODD2, 128)));
+		__UNALIGNED_UINT32_WRITE(pPixels + i, __PKHBT(Even >> 8, Odd >> 8, 16));
+		Pair0 = Pair1;
+		Pair1 = Pair2;
+	}
+	if (i < Count) {
+		Pair2 = LoadPair(pPixels, i + 2, Count);
+		Even = __SMLAD(Pair0, SMOOTH_EVEN0, __SMLAD(Pair1, SMOOTH_EVEN1, __SMLAD(Pair2, SMOOTH_EVEN2, 128)));
+		pPixels[i] = Even >> 8;
+	}
+}
+#else
+void SMOOTH_Trace(uint16_t *pPixels, uint8_t Count)
+{
+	uint16_t Far0 = pPixels[0];
+	uint16_t Near0 = pPixels[0];
+	uint16_t Center = pPixels[0];
+	uint16_t Near1 = pPixels[1];
+	uint16_t Far1 = pPixels[2];
+	uint8_t i;
+
+	for (i = 0; i < Count; i++) {
+		const uint32_t Sum = (Center * SMOOTH_WEIGHT_CENTER) + ((Near0 + Near1) * SMOOTH_WEIGHT_NEAR) + ((Far0 + Far1) * SMOOTH_WEIGHT_FAR);
+
+		pPixels[i] = (Sum + 128) >> 8;
+
+		Far0 = Near0;
+		Near0 = Center;
+		Center = Near1;
+		Near1 = Far1;
+		if (i + 3 < Count) {
+			Far1 = pPixels[i + 3];
+		}
+	}
+}
+#endif
@@ -0,0 +1,32 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef APP_SMOOTH_H
+#define APP_SMOOTH_H
+
+#include <stdint.h>
+
+// Moving window - weighted average of 5 points of the spectrum to smooth spectrum in the frequency domain.
+// Weights in 1/256: x: 128 (50%), x-1/x+1: 46 (18%), x-2/x+2: 18 (7%), the edges are extended.
+#define SMOOTH_WEIGHT_CENTER 128
+#define SMOOTH_WEIGHT_NEAR 46
+#define SMOOTH_WEIGHT_FAR 18
+
+void SMOOTH_Trace(uint16_t *pPixels, uint8_t Count);
+
+#endif
+
@@ -0,0 +1,63 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/activity.h"
+#include "app/snapshot.h"
+#include "radio/flash-ring.h"
+
+// A ring of 512 byte slots in two sectors, 8 slots per sector. A save only programs the
+// pages of the next slot; a sector is erased when the ring moves into it, which happens
+// once every 8 snapshots.
+#define SNAPSHOT_ADDRESS	0x3E4000U
+#define SNAPSHOT_MAGIC		0x31535053U // "SPS1"
+
+static const FlashRing_t Ring = { SNAPSHOT_ADDRESS, SNAPSHOT_MAGIC, SNAPSHOT_SLOT_SIZE, SNAPSHOT_SLOTS };
+
+static uint32_t Sequence;
+static uint8_t NextSlot;
+
+uint32_t SNAPSHOT_GetAddress(uint8_t Slot)
+{
+	return FLASHRING_GetAddress(&Ring, Slot);
+}
+
+void SNAPSHOT_Init(void)
+{
+	const uint8_t Latest = FLASHRING_FindLatest(&Ring, &Sequence);
+
+	NextSlot = (Latest < SNAPSHOT_SLOTS) ? (Latest + 1) % SNAPSHOT_SLOTS : 0;
+}
+
+// The header and the RSSI values are programmed straight from where they are, no slot
+// image is needed in RAM. Returns the slot used.
+uint8_t SNAPSHOT_Save(SnapshotHeader_t *pHeader, const uint16_t *pRssi)
+{
+	const uint8_t Slot = NextSlot;
+
+	if (pHeader->Count > SNAPSHOT_MAX_BINS) {
+		pHeader->Count = SNAPSHOT_MAX_BINS;
+	}
+	pHeader->Magic = SNAPSHOT_MAGIC;
+	pHeader->Sequence = ++Sequence;
+	pHeader->Clock = ACTIVITY_GetClock();
+
+	FLASHRING_Write(&Ring, Slot, 0, pHeader, sizeof(*pHeader));
+	FLASHRING_Write(&Ring, Slot, sizeof(*pHeader), pRssi, pHeader->Count * sizeof(*pRssi));
+
+	NextSlot = (Slot + 1) % SNAPSHOT_SLOTS;
+
+	return Slot;
+}
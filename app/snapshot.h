@@ -0,0 +1,47 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_SNAPSHOT_H
+#define APP_SNAPSHOT_H
+
+#include <stdint.h>
+
+#define SNAPSHOT_MAX_BINS	160
+#define SNAPSHOT_SLOT_SIZE	512U
+#define SNAPSHOT_SLOTS		16U
+
+// Stored at the start of each slot, followed by Count RSSI values of 16 bits.
+typedef struct {
+	uint32_t Magic;
+	uint32_t Sequence;
+	uint32_t Clock;
+	uint32_t FreqMin;
+	uint32_t FreqStep;
+	uint16_t ScanDelay;
+	uint16_t SquelchLevel;
+	uint8_t Count;
+	uint8_t Modulation;
+	uint8_t bNarrow;
+	uint8_t bWaterfall;
+	uint8_t Reserved[4];
+} SnapshotHeader_t;
+
+void SNAPSHOT_Init(void);
+uint8_t SNAPSHOT_Save(SnapshotHeader_t *pHeader, const uint16_t *pRssi);
+uint32_t SNAPSHOT_GetAddress(uint8_t Slot);
+
+#endif
+
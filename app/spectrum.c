@@ -15,8 +15,13 @@
  */
 
 #include "misc.h"
+#include "app/activity.h"
+#include "app/lock.h"
+#include "app/smooth.h"
+#include "app/snapshot.h"
 #include "app/spectrum.h"
 #include "app/radio.h"
+#include "driver/battery.h"
 #include "driver/bk4819.h"
 #include "driver/delay.h"
 #include "driver/key.h"
@@ -25,7 +30,12 @@
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "radio/channels.h"
+#include "radio/detector.h"
+#include "radio/frequencies.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "task/keyaction.h"
+#include "task/lock.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
 #include "ui/main.h"
@@ -33,8 +43,13 @@
 #include "gradient.h"
 #include "driver/st7735s.h"
 
-#ifdef UART_DEBUG
+#ifdef ENABLE_SPECTRUM_STREAM
+#include "app/uart.h"
+#endif
+#if defined(UART_DEBUG) || defined(ENABLE_SPECTRUM_STREAM)
 #include "driver/uart.h"
+#endif
+#ifdef UART_DEBUG
 #include "external/printf/printf.h"
 #endif
 
@@ -75,14 +90,22 @@ uint8_t bMode;
 uint16_t RssiLow;
 uint16_t RssiHigh;
 
-uint16_t KeyHoldTimer = 0;
+uint32_t KeyHoldTime = 0;
 uint8_t bHold;
 
 KEY_t Key;
 KEY_t LastKey = KEY_NONE;
+uint8_t bKeyUsed;
 
 uint8_t scroll;
 
+uint8_t PeakSelect; // 1 .. RefinedPeakCount, 0 for none
+uint8_t bProgressive;
+
+#ifdef ENABLE_SPECTRUM_STREAM
+uint8_t bStreaming;
+#endif
+
 ////////////////////////////////////////////////////////////////
 
 // WATERFALL AND SPECTRUM
@@ -90,12 +113,71 @@ uint8_t scroll;
 #define SPECTRUM_WIDTH 160
 #define WATERFALL_HEIGHT 1
 
+#define SPECTRUM_RIGHT_MARGIN 0
+#define SPECTRUM_LEFT_MARGIN 0
+#define SPECTRUM_X 0	   // x offset
+#define SPECTRUM_Y 12	   // y offset
+#define SPECTRUM_HEIGHT 40 // spectrum max. height
+
+#define WATERFALL_RIGHT_MARGIN 0
+#define WATERFALL_LEFT_MARGIN 0
+#define H_WATERFALL_WIDTH 127
+
+#define SCROLL_LEFT_MARGIN 55
+#define SCROLL_RIGHT_MARGIN 160
+
+// Number of bins measured per main loop iteration
+#define SPECTRUM_BINS_PER_STEP 8
+
+// The keys are polled on every step, a held key repeats after KEY_REPEAT_MS. While the keypad
+// is locked only a KEY_LONG_MS press of the key with the lock shortcut works, as on the main screen.
+#define KEY_REPEAT_MS 300
+#define KEY_LONG_MS 1000
+
+// Refine: after every sweep the strongest tracked peaks are measured again with a
+// step REFINE_DIVIDER times finer, over +/- one coarse step around each peak.
+#define REFINE_PEAKS 3
+#define REFINE_DIVIDER 10
+#define REFINE_POINTS ((2 * REFINE_DIVIDER) + 1)
+
+// Peak tracker: the TRACK_PEAKS strongest signals, updated as each bin is measured.
+#define TRACK_PEAKS 5
+#define TRACK_MIN_LEVEL 10    // ignore bins closer than 5dB to the floor of the previous sweep
+#define TRACK_MERGE 2         // bins this close belong to the same peak
+#define TRACK_HYSTERESIS 6    // a new peak must beat the weakest one by 3dB to replace it
+#define TRACK_AGE_PENALTY 6   // score lost per sweep a peak has not been seen
+#define TRACK_MAX_AGE 3       // sweeps before an unseen peak is dropped
+
+// Fast find: the BK4819 frequency scanner is run on the UHF then the VHF front end filter.
+#define FIND_SETTLE_MS 200
+#define FIND_TIMEOUT_MS 1200
+
+// Distance between the bins of the first pass of a progressive sweep, must be a power of 2.
+#define PROGRESSIVE_STRIDE 16
+
+#ifdef ENABLE_SPECTRUM_WATCH
+// The home VFO is checked every WATCH_SWEEPS sweeps or WATCH_INTERVAL_MS, whichever comes first.
+#define WATCH_SWEEPS 4
+#define WATCH_INTERVAL_MS 500
+#define WATCH_DWELL_MS 8
+#endif
+
 uint8_t offset = 0;
 
 uint8_t waterfall[WATERFALL_HEIGHT][SPECTRUM_WIDTH];
 
 uint8_t cnt, waterfall_line;
 
+#ifdef ENABLE_SPECTRUM_STREAM
+// Sweep frame sent over USART1, all multi-byte fields are little endian:
+//   0xAA 0x55, sequence, bin count, start frequency (u32, 10 Hz), step (u32, 10 Hz),
+//   one byte per bin (RSSI / 2, i.e. dBm + 160), 8-bit sum of everything after the sync word.
+#define STREAM_HEADER_SIZE 12
+
+static uint8_t StreamFrame[STREAM_HEADER_SIZE + SPECTRUM_WIDTH + 1];
+static uint8_t StreamSequence;
+#endif
+
 const char *StepStrings[] = {
 	"0.25K",
 	"1.25K",
@@ -175,6 +257,14 @@ void DrawCurrentFreq(uint16_t Color)
 
 ////////////////////////////////////////////////////////////////
 
+#ifdef ENABLE_SPECTRUM_WATCH
+// BK4819_CheckSquelchLink() is always true with squelch 0, so the watch needs an active squelch.
+static uint8_t IsWatchEnabled(void)
+{
+	return !gExtendedSettings.SpectrumWatchOff && gSettings.Squelch;
+}
+#endif
+
 void DrawLabels(void)
 {
 
@@ -210,6 +300,14 @@ void DrawLabels(void)
 
 		UI_DrawSmallString(2, 14, (bHold) ? "H" : " ", 1);
 
+#ifdef ENABLE_SPECTRUM_STREAM
+		UI_DrawSmallString(2, 82, (bStreaming) ? "S" : " ", 1);
+#endif
+		UI_DrawSmallString(8, 82, (bProgressive) ? "P" : " ", 1);
+#ifdef ENABLE_SPECTRUM_WATCH
+		UI_DrawSmallString(14, 82, IsWatchEnabled() ? "D" : " ", 1);
+#endif
+
 		gColorForeground = COLOR_GREY;
 
 		Int2Ascii(CurrentFreqChangeStep / 10, 5);
@@ -249,6 +347,13 @@ void DrawLabels(void)
 
 		UI_DrawSmallString(30, 60, (bHold) ? "H" : " ", 1);
 
+#ifdef ENABLE_SPECTRUM_STREAM
+		UI_DrawSmallString(45, 60, (bStreaming) ? "S" : " ", 1);
+#endif
+#ifdef ENABLE_SPECTRUM_WATCH
+		UI_DrawSmallString(45, 40, IsWatchEnabled() ? "D" : " ", 1);
+#endif
+
 		// Int2Ascii(offset, 5);
 		// UI_DrawSmallString(2, 20, gShortString, 5);
 
@@ -266,6 +371,8 @@ void DrawLabels(void)
 
 ////////////////////////////////////////////////////////////////
 
+static void ResetPeakTracker(void);
+
 void SetFreqMinMax(void)
 {
 	if (bMode)
@@ -278,6 +385,8 @@ void SetFreqMinMax(void)
 	FREQUENCY_SelectBand(FreqCenter);
 	BK4819_EnableFilter(bFilterEnabled);
 	RssiValue[CurrentFreqIndex] = 0; // Force a rescan
+	ResetPeakTracker();
+	bRestartScan = TRUE;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -290,15 +399,6 @@ void SetStepCount(void)
 		CurrentStepCount = 128 >> CurrentStepCountIndex;
 }
 
-////////////////////////////////////////////////////////////////
-
-void IncrementStepIndex(void)
-{
-	CurrentStepCountIndex = (CurrentStepCountIndex + 1) % STEPS_COUNT;
-	SetStepCount();
-	SetFreqMinMax();
-	DrawLabels();
-}
 
 ////////////////////////////////////////////////////////////////
 
@@ -446,30 +546,128 @@ void StopSpectrum(void)
 
 	RADIO_Tune(gSettings.CurrentVfo);
 	UI_DrawMain(false);
+
+	// Swallow the key that closed the spectrum so the main screen does not see it
+	KEY_LongPressed = true;
+	KEY_KeyCounter = 0;
+}
+
+void show_waterfall_vertical()
+{
+	uint8_t lptr = WATERFALL_HEIGHT - waterfall_line; // get current line of "bottom" of waterfall in circular buffer
+
+	lptr %= WATERFALL_HEIGHT; // do modulus limit of spectrum high
+
+	uint8_t lcnt = 0; // initialize count of number of lines of display
+
+	// Waterfall software scrolling (st7735 does not support horizontal scrolling)
+	for (lcnt = 0; lcnt < WATERFALL_HEIGHT; lcnt++)
+	{
+		ST7735S_SetAddrWindow(0, WATERFALL_HEIGHT - lcnt, SPECTRUM_WIDTH, WATERFALL_HEIGHT - lcnt);
+
+		for (uint8_t i = 0; i < (SPECTRUM_WIDTH); i++)
+		{
+			uint16_t wf = (waterfall_rainbow[63 - waterfall[lptr][i]]);
+			ST7735S_SendU16(wf); // write to memory using waterfall color from palette
+		}
+
+		lptr++;					  // point to next line in circular display buffer
+		lptr %= WATERFALL_HEIGHT; // clip to display height
+	}
+
+	waterfall_line++;
+	waterfall_line %= WATERFALL_HEIGHT;
+}
+
+void scroll_waterfall()
+{
+	scroll++;
+	scroll %= (SCROLL_RIGHT_MARGIN - SCROLL_LEFT_MARGIN);
+
+	ST7735S_scroll(scroll);
+
+	ST7735S_SetAddrWindow((SCROLL_RIGHT_MARGIN)-scroll, 0, (SCROLL_RIGHT_MARGIN)-scroll, 127);
+
+	for (uint8_t i = 0; i < 127; i++)
+	{
+		uint16_t wf = (waterfall_rainbow[RssiValue[i] - RssiLow - offset]);
+		ST7735S_SendU16(wf); // write to screen using waterfall color from palette
+	}
+
+	ST7735S_SetPixel(54, CurrentFreqIndex_old, COLOR_BACKGROUND);
+	ST7735S_SetPixel(53, CurrentFreqIndex_old, COLOR_BACKGROUND);
+	ST7735S_SetPixel(52, CurrentFreqIndex_old, COLOR_BACKGROUND);
+
+	CurrentFreqIndex_old = CurrentFreqIndex;
+
+	ST7735S_SetPixel(54, CurrentFreqIndex, COLOR_GREY);
+	ST7735S_SetPixel(53, CurrentFreqIndex, COLOR_GREY);
+	ST7735S_SetPixel(52, CurrentFreqIndex, COLOR_GREY);
 }
 
-void show_waterfall(void);
-void show_spectrum(void);
+static void StartSpectrum(void);
+static void StartWaterfall(void);
+static void StartFind(void);
+static void DrawSelectedPeak(void);
+
+static uint8_t RefinedPeakCount;
 
 ////////////////////////////////////////////////////////////////
 
+static uint8_t GetLongAction(KEY_t Key)
+{
+	switch (Key)
+	{
+	case KEY_STAR:
+		return gExtendedSettings.KeyShortcut[10];
+	case KEY_HASH:
+		return gExtendedSettings.KeyShortcut[11];
+	case KEY_MENU:
+		return gExtendedSettings.KeyShortcut[12];
+	default:
+		return (Key <= KEY_9) ? gExtendedSettings.KeyShortcut[Key] : ACTION_NONE;
+	}
+}
+
 void CheckKeys(void)
 {
 	Key = KEY_GetButton();
-	if (Key == LastKey && Key != KEY_NONE)
+	if (gEnableBlink && Key != KEY_NONE)
+	{ // first key press only wakes the display up
+		SCREEN_TurnOn();
+		LastKey = Key;
+		return;
+	}
+	if (gSettings.Lock)
 	{
-		if (bRXMode)
+		if (Key != LastKey)
 		{
-			KeyHoldTimer += 10;
+			KeyHoldTime = gTimeSinceBoot;
 		}
-		else
+		else if (Key != KEY_NONE && !bKeyUsed && gTimeSinceBoot - KeyHoldTime >= KEY_LONG_MS && GetLongAction(Key) == ACTION_LOCK)
+		{
+			LOCK_Toggle();
+			bKeyUsed = TRUE;
+		}
+		LastKey = Key;
+		return;
+	}
+	if (bKeyUsed)
+	{ // the key that unlocked the keypad does nothing else
+		if (Key == LastKey)
 		{
-			KeyHoldTimer++;
+			return;
 		}
+		bKeyUsed = FALSE;
 	}
-	if (Key != LastKey || KeyHoldTimer >= 50)
+	if (Key != LastKey || (Key != KEY_NONE && gTimeSinceBoot - KeyHoldTime >= KEY_REPEAT_MS))
 	{
-		KeyHoldTimer = 0;
+		KeyHoldTime = gTimeSinceBoot;
+		if (Key != KEY_NONE)
+		{
+			SCREEN_TurnOn();
+			gLockTimer = 0;
+		}
 		switch (Key)
 		{
 		case KEY_NONE:
@@ -502,11 +700,19 @@ void CheckKeys(void)
 			};
 			break;
 		case KEY_1:
-			IncrementStepIndex();
+			StartFind();
 			break;
-		case KEY_2: // offset the waterfall gradient
-			offset++;
-			offset %= 32;
+		case KEY_2:
+			if (bMode)
+			{ // cycle the refined peak to listen to: off, 1 (strongest) .. RefinedPeakCount
+				PeakSelect = (PeakSelect < RefinedPeakCount) ? PeakSelect + 1 : 0;
+				DrawSelectedPeak();
+			}
+			else
+			{ // offset the waterfall gradient
+				offset++;
+				offset %= 32;
+			}
 			break;
 		case KEY_3:
 			IncrementModulation();
@@ -514,7 +720,15 @@ void CheckKeys(void)
 		case KEY_4:
 			IncrementFreqStepIndex();
 			break;
-		case KEY_5: // switch between spectrum and waterfall
+		case KEY_5: // cycle between spectrum, progressive spectrum and waterfall
+			if (bMode && !bProgressive)
+			{
+				bProgressive = 1;
+				bRestartScan = TRUE;
+				DrawLabels();
+				break;
+			}
+			bProgressive = 0;
 			bMode ^= 1;
 			if (bRXMode)
 			{
@@ -527,9 +741,9 @@ void CheckKeys(void)
 			DELAY_WaitMS(500);
 			ST7735S_Init();
 			if (bMode)
-				show_spectrum();
+				StartSpectrum();
 			else
-				show_waterfall();
+				StartWaterfall();
 			break;
 		case KEY_6:
 			ChangeSquelchLevel(TRUE);
@@ -539,6 +753,10 @@ void CheckKeys(void)
 			DrawLabels();
 			break;
 		case KEY_8:
+#ifdef ENABLE_SPECTRUM_STREAM
+			bStreaming ^= 1;
+			DrawLabels();
+#endif
 			break;
 		case KEY_9:
 			ChangeSquelchLevel(FALSE);
@@ -563,6 +781,7 @@ void Spectrum_StartAudio(void)
 {
 	gReceivingAudio = true;
 
+	SCREEN_TurnOn();
 	gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
 	gRadioMode = RADIO_MODE_RX;
 	OpenAudio(bNarrow, CurrentModulation);
@@ -600,332 +819,1000 @@ void Spectrum_StartAudio(void)
 	SPEAKER_TurnOn(SPEAKER_OWNER_RX);
 }
 
-void RunRX(void)
+////////////////////////////////////////////////////////////////
+
+// The sweep is a resumable state machine: SPECTRUM_Step() measures at most
+// SPECTRUM_BINS_PER_STEP bins and returns to the main loop, so the other tasks
+// keep running with a latency of a few milliseconds. Task_Spectrum() runs it
+// at most once per 1 ms scheduler tick.
+
+typedef struct
+{
+	uint32_t Frequency;
+	uint16_t Rssi;
+	uint8_t Bin;
+} RefinedPeak_t;
+
+typedef struct
+{
+	uint16_t Rssi; // 0 for an unused entry
+	uint8_t Bin;
+	uint8_t Age;
+} TrackedPeak_t;
+
+static uint8_t SweepIndex;
+static uint8_t ProgressivePass;
+static uint8_t bFinding;
+static uint8_t FindBand;
+static uint32_t FindStart;
+static TrackedPeak_t TrackedPeaks[TRACK_PEAKS];
+static uint8_t TrackedPeakCount;
+static uint16_t TrackFloor = 330;
+static uint32_t FreqToCheck;
+static RefinedPeak_t RefinedPeaks[REFINE_PEAKS];
+static uint8_t RefinePeakIndex;
+static uint8_t RefinePoint;
+static uint32_t RefineStep;
+static uint8_t bRefining;
+static uint16_t y1_old_minus;
+static uint16_t y1_new_minus;
+static uint8_t LastBatteryVoltage;
+static uint8_t bSnapshotRequested;
+#ifdef ENABLE_SPECTRUM_WATCH
+static RADIO_FastTune_t HomeTune;
+static uint32_t WatchTime;
+static uint8_t WatchSweeps;
+#endif
+
+static void ResetPeakTracker(void)
 {
-	bRXMode = TRUE;
-	Spectrum_StartAudio();
+	uint8_t i;
 
-	while (RssiValue[CurrentFreqIndex] > SquelchLevel)
+	for (i = 0; i < TRACK_PEAKS; i++)
 	{
-		RssiValue[CurrentFreqIndex] = BK4819_GetRSSI();
-		CheckKeys();
-		if (bExit)
-		{
-			RADIO_EndAudio();
-			return;
-		}
-		DrawCurrentFreq(COLOR_GREEN);
-		DELAY_WaitUS(CurrentScanDelay);
+		TrackedPeaks[i].Rssi = 0;
 	}
-
-	RADIO_EndAudio();
-	bRXMode = FALSE;
+	TrackedPeakCount = 0;
 }
-////////////////////////////////////////////////////////////////
 
-void show_spectrum()
+static int16_t GetPeakScore(const TrackedPeak_t *pPeak)
 {
-#define SPECTRUM_RIGHT_MARGIN 0
-#define SPECTRUM_LEFT_MARGIN 0
-
-	uint32_t FreqToCheck;
-	CurrentFreqIndex = 0;
-	CurrentFreqIndex_old = 0;
-	CurrentFreq = FreqMin;
-	bResetSquelch = TRUE;
-	bRestartScan = FALSE;
+	if (!pPeak->Rssi)
+	{
+		return -1;
+	}
 
-	uint16_t y_old, y_new, y1_new, y1_old;
-	uint16_t y1_old_minus = 0;
-	uint16_t y1_new_minus = 0;
+	return pPeak->Rssi - (pPeak->Age * TRACK_AGE_PENALTY);
+}
 
-	uint8_t spectrum_x = 0;		  // x offset
-	uint8_t spectrum_y = 12;	  // y offset
-	uint8_t spectrum_height = 40; // spectrum max. height
+static void AgeTrackedPeaks(void)
+{
+	uint8_t i;
 
-	UI_DrawStatusIcon(139, ICON_BATTERY, true, COLOR_FOREGROUND);
-	UI_DrawBattery(false);
+	for (i = 0; i < TRACK_PEAKS; i++)
+	{
+		if (TrackedPeaks[i].Rssi && ++TrackedPeaks[i].Age > TRACK_MAX_AGE)
+		{
+			TrackedPeaks[i].Rssi = 0;
+		}
+	}
+}
 
-	DrawLabels();
+// O(TRACK_PEAKS) per bin: the bin refreshes the peak it belongs to, or replaces the weakest one.
+// A peak not refreshed yet in this sweep (Age != 0) takes the new reading even if it is lower.
+static void TrackBin(uint8_t Bin, uint16_t Rssi)
+{
+	TrackedPeak_t *pWeakest = &TrackedPeaks[0];
+	int16_t WeakestScore = INT16_MAX;
+	uint8_t i;
 
-	while (1)
+	if (Rssi < TrackFloor + TRACK_MIN_LEVEL)
 	{
+		return;
+	}
 
-		FreqToCheck = FreqMin;
-		bRestartScan = TRUE;
+	for (i = 0; i < TRACK_PEAKS; i++)
+	{
+		TrackedPeak_t *pPeak = &TrackedPeaks[i];
+		const int16_t Score = GetPeakScore(pPeak);
 
-		for (uint8_t i = SPECTRUM_LEFT_MARGIN; i < SPECTRUM_WIDTH - SPECTRUM_RIGHT_MARGIN; i++)
+		if (pPeak->Rssi && pPeak->Bin + TRACK_MERGE >= Bin && Bin + TRACK_MERGE >= pPeak->Bin)
 		{
-
-			if (bRestartScan)
+			if (pPeak->Age || Rssi > pPeak->Rssi)
 			{
-				bRestartScan = FALSE;
-				RssiLow = 330;
-				RssiHigh = 72;
-				i = SPECTRUM_LEFT_MARGIN;
+				pPeak->Rssi = Rssi;
+				pPeak->Bin = Bin;
+				pPeak->Age = 0;
 			}
+			return;
+		}
+		if (Score < WeakestScore)
+		{
+			pWeakest = pPeak;
+			WeakestScore = Score;
+		}
+	}
 
-			BK4819_set_rf_frequency(FreqToCheck, true); // set the VCO/PLL
+	if (!pWeakest->Rssi || Rssi > WeakestScore + TRACK_HYSTERESIS)
+	{
+		pWeakest->Rssi = Rssi;
+		pWeakest->Bin = Bin;
+		pWeakest->Age = 0;
+	}
+}
 
-			DELAY_WaitUS(CurrentScanDelay); // 700uS seems the lower delay for real rssi measures for this loop.
+// Strongest first, a peak seen in this sweep ranks above a stale one of the same level.
+static void SortTrackedPeaks(void)
+{
+	uint8_t i, j;
 
-			FreqToCheck += CurrentFreqStep;
+	TrackedPeakCount = 0;
+	for (i = 1; i < TRACK_PEAKS; i++)
+	{
+		const TrackedPeak_t Peak = TrackedPeaks[i];
 
-			// moving window - weighted average of 5 points of the spectrum to smooth spectrum in the frequency domain
-			// weights:  x: 50% , x-1/x+1: 36%, x+2/x-2: 14%
+		for (j = i; j > 0 && GetPeakScore(&TrackedPeaks[j - 1]) < GetPeakScore(&Peak); j--)
+		{
+			TrackedPeaks[j] = TrackedPeaks[j - 1];
+		}
+		TrackedPeaks[j] = Peak;
+	}
+	while (TrackedPeakCount < TRACK_PEAKS && TrackedPeaks[TrackedPeakCount].Rssi)
+	{
+		TrackedPeakCount++;
+	}
+}
 
-			y_new = pixelnew[i]; // * 0.5 + pixelnew[i - 1] * 0.18 + pixelnew[i + 1] * 0.18 + pixelnew[i - 2] * 0.07 + pixelnew[i + 2] * 0.07;
-			y_old = pixelold[i]; // * 0.5 + pixelold[i - 1] * 0.18 + pixelold[i + 1] * 0.18 + pixelold[i - 2] * 0.07 + pixelold[i + 2] * 0.07;
+static void StartSweep(void)
+{
+	bRestartScan = FALSE;
+	AgeTrackedPeaks();
+	bRefining = FALSE;
+	ProgressivePass = 0;
+	RssiLow = 330;
+	RssiHigh = 72;
+	FreqToCheck = FreqMin;
+	SweepIndex = 0;
+#ifdef ENABLE_SPECTRUM_WATCH
+	WatchSweeps++;
+#endif
+}
 
-			if (y_old > (spectrum_height - 1))
-			{
-				y_old = (spectrum_height - 1);
-			}
+static uint8_t GetSweepWidth(void)
+{
+	if (bMode)
+		return SPECTRUM_WIDTH - SPECTRUM_RIGHT_MARGIN - SPECTRUM_LEFT_MARGIN;
+	else
+		return H_WATERFALL_WIDTH - WATERFALL_RIGHT_MARGIN - WATERFALL_LEFT_MARGIN;
+}
 
-			if (y_new > (spectrum_height - 1))
-			{
-				y_new = (spectrum_height - 1);
-			}
+static void DrawBatteryLevel(void)
+{
+	// The battery gauge shares the screen with the trace, so it is only
+	// refreshed in spectrum mode and only when the voltage has changed.
+	if (bMode && LastBatteryVoltage != gBatteryVoltage)
+	{
+		LastBatteryVoltage = gBatteryVoltage;
+		UI_DrawBattery(false);
+	}
+}
 
-			if (y_old < 0)
-				y_old = 0;
-			if (y_new < 0)
-				y_new = 0;
+// Replaces the trace point drawn for pixelold[i] with pixelnew[i], columns must be drawn left to right.
+static void DrawSpectrumColumn(uint8_t i)
+{
+	uint16_t y_old, y_new, y1_new, y1_old;
 
-			y1_old = y_old + spectrum_y;
-			y1_new = y_new + spectrum_y;
+	// pixelnew[] has been smoothed by SMOOTH_Trace() at the end of the sweep that measured it
+	y_new = pixelnew[i];
+	y_old = pixelold[i];
 
-			if (i == SPECTRUM_LEFT_MARGIN)
-			{
-				y1_old_minus = y1_old;
-				y1_new_minus = y1_new;
-			}
-			if (i == SPECTRUM_WIDTH - SPECTRUM_RIGHT_MARGIN)
-			{
-				y1_old_minus = y1_old;
-				y1_new_minus = y1_new;
-			}
+	if (y_old > (SPECTRUM_HEIGHT - 1))
+	{
+		y_old = (SPECTRUM_HEIGHT - 1);
+	}
 
-			// DELETE OLD LINE/POINT
-			if (y1_old - y1_old_minus > 1)
-			{ // plot line upwards
-				ST7735S_DrawFastLine(i + spectrum_x, y1_old_minus + 1, y1_old - y1_old_minus, COLOR_BACKGROUND, 1);
-			}
-			else if (y1_old - y1_old_minus < -1)
-			{ // plot line downwards
-				ST7735S_DrawFastLine(i + spectrum_x, y1_old, y1_old_minus - y1_old, COLOR_BACKGROUND, 1);
-			}
-			else
-			{
-				ST7735S_SetPixel(i + spectrum_x, y1_old, COLOR_BACKGROUND); // delete old pixel
-			}
+	if (y_new > (SPECTRUM_HEIGHT - 1))
+	{
+		y_new = (SPECTRUM_HEIGHT - 1);
+	}
 
-			// DRAW NEW LINE/POINT
-			if (y1_new - y1_new_minus > 1)
-			{ // plot line upwards
-				ST7735S_DrawFastLine(i + spectrum_x, y1_new_minus + 1, y1_new - y1_new_minus, COLOR_GREEN, 1);
-			}
-			else if (y1_new - y1_new_minus < -1)
-			{ // plot line downwards
-				ST7735S_DrawFastLine(i + spectrum_x, y1_new, y1_new_minus - y1_new, COLOR_GREEN, 1);
-			}
-			else
-			{
-				ST7735S_SetPixel(i + spectrum_x, y1_new, COLOR_GREEN); // write new pixel
-			}
+	y1_old = y_old + SPECTRUM_Y;
+	y1_new = y_new + SPECTRUM_Y;
 
-			y1_new_minus = y1_new;
-			y1_old_minus = y1_old;
+	if (i == SPECTRUM_LEFT_MARGIN)
+	{
+		y1_old_minus = y1_old;
+		y1_new_minus = y1_new;
+	}
 
-			pixelold[i] = pixelnew[i];
+	// DELETE OLD LINE/POINT
+	if (y1_old - y1_old_minus > 1)
+	{ // plot line upwards
+		ST7735S_DrawFastLine(i + SPECTRUM_X, y1_old_minus + 1, y1_old - y1_old_minus, COLOR_BACKGROUND, 1);
+	}
+	else if (y1_old - y1_old_minus < -1)
+	{ // plot line downwards
+		ST7735S_DrawFastLine(i + SPECTRUM_X, y1_old, y1_old_minus - y1_old, COLOR_BACKGROUND, 1);
+	}
+	else
+	{
+		ST7735S_SetPixel(i + SPECTRUM_X, y1_old, COLOR_BACKGROUND); // delete old pixel
+	}
 
-			RssiValue[i] = BK4819_GetRSSI();
+	// DRAW NEW LINE/POINT
+	if (y1_new - y1_new_minus > 1)
+	{ // plot line upwards
+		ST7735S_DrawFastLine(i + SPECTRUM_X, y1_new_minus + 1, y1_new - y1_new_minus, COLOR_GREEN, 1);
+	}
+	else if (y1_new - y1_new_minus < -1)
+	{ // plot line downwards
+		ST7735S_DrawFastLine(i + SPECTRUM_X, y1_new, y1_new_minus - y1_new, COLOR_GREEN, 1);
+	}
+	else
+	{
+		ST7735S_SetPixel(i + SPECTRUM_X, y1_new, COLOR_GREEN); // write new pixel
+	}
 
-			pixelnew[i] = ((((RssiValue[i] - 72) * 100) / 258) * .8); // 2x
+	y1_new_minus = y1_new;
+	y1_old_minus = y1_old;
 
-			if (RssiValue[i] < RssiLow)
-			{
-				RssiLow = RssiValue[i];
-			}
-			else if (RssiValue[i] > RssiHigh)
-			{
-				RssiHigh = RssiValue[i];
-			}
+	pixelold[i] = pixelnew[i];
+}
 
-			if (RssiValue[i] > RssiValue[CurrentFreqIndex] && !bHold)
-			{
-				CurrentFreqIndex = i;
-				CurrentFreq = FreqToCheck;
-			}
-		}
+static void ReadSpectrumBin(uint8_t i)
+{
+	RssiValue[i] = BK4819_GetRSSI();
+	TrackBin(i, RssiValue[i]);
 
-		// Draw a yellow circle at the spectrum peak.
+	pixelnew[i] = ((((RssiValue[i] - 72) * 100) / 258) * .8); // 2x
 
-		DISPLAY_drawCircle(CurrentFreqIndex_old, (pixelold[CurrentFreqIndex_old] + spectrum_y), 3, COLOR_BACKGROUND);
+	if (RssiValue[i] < RssiLow)
+	{
+		RssiLow = RssiValue[i];
+	}
+	else if (RssiValue[i] > RssiHigh)
+	{
+		RssiHigh = RssiValue[i];
+	}
 
-		CurrentFreqIndex_old = CurrentFreqIndex;
-		DISPLAY_drawCircle(CurrentFreqIndex, (pixelnew[CurrentFreqIndex] + spectrum_y), 3, COLOR_RGB(255, 255, 0));
+	if (RssiValue[i] > RssiValue[CurrentFreqIndex] && !bHold)
+	{
+		CurrentFreqIndex = i;
+		CurrentFreq = FreqToCheck;
+	}
+}
 
-		if (bResetSquelch)
-		{
-			bResetSquelch = FALSE;
-			SquelchLevel = RssiHigh + 5;
-		}
+static void MeasureSpectrumBin(uint8_t i)
+{
+	BK4819_set_rf_frequency(FreqToCheck, true); // set the VCO/PLL
 
-		if (RssiValue[CurrentFreqIndex] > SquelchLevel)
-		{
-			BK4819_set_rf_frequency(CurrentFreq, TRUE);
-			DELAY_WaitUS(CurrentScanDelay);
-			RunRX();
-		}
+	DELAY_WaitUS(CurrentScanDelay); // 700uS seems the lower delay for real rssi measures for this loop.
 
-		DrawCurrentFreq(COLOR_BLUE);
+	FreqToCheck += CurrentFreqStep;
 
-		CheckKeys();
-		if (bExit)
-		{
-			return;
-		}
-	}
+	DrawSpectrumColumn(i);
+	ReadSpectrumBin(i);
 }
 
-void show_waterfall_vertical()
+static void MeasureWaterfallBin(uint8_t i)
 {
-	uint8_t lptr = WATERFALL_HEIGHT - waterfall_line; // get current line of "bottom" of waterfall in circular buffer
+	BK4819_set_rf_frequency(FreqToCheck, true); // set the VCO/PLL
 
-	lptr %= WATERFALL_HEIGHT; // do modulus limit of spectrum high
+	DELAY_WaitUS(CurrentScanDelay + 500); // waterfall loop needs more delay than the spectrum one so the +500us.
 
-	uint8_t lcnt = 0; // initialize count of number of lines of display
+	RssiValue[i] = BK4819_GetRSSI();
+	TrackBin(i, RssiValue[i]);
 
-	// Waterfall software scrolling (st7735 does not support horizontal scrolling)
-	for (lcnt = 0; lcnt < WATERFALL_HEIGHT; lcnt++)
+	if (RssiValue[i] < RssiLow)
 	{
-		ST7735S_SetAddrWindow(0, WATERFALL_HEIGHT - lcnt, SPECTRUM_WIDTH, WATERFALL_HEIGHT - lcnt);
+		RssiLow = RssiValue[i];
+	}
+	else if (RssiValue[i] > RssiHigh)
+	{
+		RssiHigh = RssiValue[i];
+	}
 
-		for (uint8_t i = 0; i < (SPECTRUM_WIDTH); i++)
+	if (RssiValue[i] > RssiValue[CurrentFreqIndex] && !bHold)
+	{
+		CurrentFreqIndex = i;
+		CurrentFreq = FreqToCheck;
+	}
+
+	FreqToCheck += CurrentFreqStep;
+}
+
+static void DrawSelectedPeak(void)
+{
+	gColorForeground = COLOR_FOREGROUND;
+	if (PeakSelect)
+	{
+		gShortString[0] = 'P';
+		gShortString[1] = 'K';
+		gShortString[2] = '0' + PeakSelect;
+		UI_DrawSmallString(2, 62, gShortString, 3);
+	}
+	else
+	{
+		UI_DrawSmallString(2, 62, "   ", 3);
+	}
+
+	if (PeakSelect && PeakSelect <= RefinedPeakCount)
+	{
+		gColorForeground = COLOR_RGB(255, 255, 0);
+		Int2Ascii(RefinedPeaks[PeakSelect - 1].Frequency, 8);
+		ShiftShortStringRight(2, 7);
+		gShortString[3] = '.';
+		UI_DrawSmallString(104, 62, gShortString, 9);
+	}
+	else
+	{
+		UI_DrawSmallString(104, 62, "         ", 9);
+	}
+}
+
+// Refined peak numbers above the trace, the selected one in yellow.
+static void DrawPeakMarkers(void)
+{
+	uint8_t i;
+
+	DISPLAY_Fill(0, 149, SPECTRUM_Y + SPECTRUM_HEIGHT + 1, SPECTRUM_Y + SPECTRUM_HEIGHT + 8, COLOR_BACKGROUND);
+	for (i = 0; i < RefinedPeakCount; i++)
+	{
+		const uint8_t X = SPECTRUM_X + RefinedPeaks[i].Bin;
+
+		if (X < 2 || X > 146)
 		{
-			uint16_t wf = (waterfall_rainbow[63 - waterfall[lptr][i]]);
-			ST7735S_SendU16(wf); // write to memory using waterfall color from palette
+			continue;
 		}
+		gColorForeground = (PeakSelect == i + 1) ? COLOR_RGB(255, 255, 0) : COLOR_GREY;
+		UI_DrawSmallCharacter(X - 2, SPECTRUM_Y + SPECTRUM_HEIGHT + 1, '1' + i);
+	}
+}
 
-		lptr++;					  // point to next line in circular display buffer
-		lptr %= WATERFALL_HEIGHT; // clip to display height
+#ifdef ENABLE_SPECTRUM_STREAM
+// The frame is handed to the interrupt driven transmitter, the sweep never waits on the UART.
+// A frame that is still in flight when the next sweep ends means the link is too slow for
+// the current scan delay, that sweep is simply not sent.
+static void SendSweep(uint8_t Count)
+{
+	uint8_t *pFrame = StreamFrame;
+	uint8_t Sum = 0;
+	uint8_t i;
+
+	if (UART_IsSendingAsync())
+	{
+		return;
 	}
 
-	waterfall_line++;
-	waterfall_line %= WATERFALL_HEIGHT;
+	*pFrame++ = 0xAA;
+	*pFrame++ = 0x55;
+	*pFrame++ = StreamSequence++;
+	*pFrame++ = Count;
+	for (i = 0; i < 4; i++)
+	{
+		*pFrame++ = (uint8_t)(FreqMin >> (i * 8));
+	}
+	for (i = 0; i < 4; i++)
+	{
+		*pFrame++ = (uint8_t)(CurrentFreqStep >> (i * 8));
+	}
+	for (i = 0; i < Count; i++)
+	{
+		const uint16_t Rssi = RssiValue[i] >> 1;
+
+		*pFrame++ = (Rssi > 0xFF) ? 0xFF : Rssi;
+	}
+	for (i = 2; i < STREAM_HEADER_SIZE + Count; i++)
+	{
+		Sum += StreamFrame[i];
+	}
+	*pFrame = Sum;
+
+	UART_SendAsync(StreamFrame, STREAM_HEADER_SIZE + Count + 1);
 }
+#endif
 
-void scroll_waterfall()
+// Saved between sweeps, or at once while receiving, so the snapshot always holds a complete sweep.
+static void CheckSnapshot(void)
 {
+	SnapshotHeader_t Header;
+	uint8_t Slot;
+	uint8_t i;
 
-#define WATERFALL_RIGHT_MARGIN 0
-#define WATERFALL_LEFT_MARGIN 0
-#define H_WATERFALL_WIDTH 127
+	if (!bSnapshotRequested)
+	{
+		return;
+	}
+	bSnapshotRequested = FALSE;
+
+	Header.FreqMin = FreqMin;
+	Header.FreqStep = CurrentFreqStep;
+	Header.ScanDelay = CurrentScanDelay;
+	Header.SquelchLevel = SquelchLevel;
+	Header.Count = GetSweepWidth();
+	Header.Modulation = CurrentModulation;
+	Header.bNarrow = bNarrow;
+	Header.bWaterfall = !bMode;
+	for (i = 0; i < sizeof(Header.Reserved); i++)
+	{
+		Header.Reserved[i] = 0;
+	}
 
-#define SCROLL_LEFT_MARGIN 55
-#define SCROLL_RIGHT_MARGIN 160
+	Slot = SNAPSHOT_Save(&Header, RssiValue);
 
-	scroll++;
-	scroll %= (SCROLL_RIGHT_MARGIN - SCROLL_LEFT_MARGIN);
+	gColorForeground = COLOR_RGB(255, 255, 0);
+	Int2Ascii(Slot + 1, 2);
+	if (bMode)
+	{
+		UI_DrawSmallString(20, 82, "SNAP", 4);
+		UI_DrawSmallString(46, 82, gShortString, 2);
+	}
+	else
+	{
+		UI_DrawSmallString(2, 50, "SNAP", 4);
+		UI_DrawSmallString(28, 50, gShortString, 2);
+	}
+}
 
-	ST7735S_scroll(scroll);
+// Every peak seen above the squelch in this sweep is logged, not just the one the receiver
+// stops on. The refined frequency is used for the peaks that have one.
+static void RecordPeaks(void)
+{
+	uint8_t i;
 
-	ST7735S_SetAddrWindow((SCROLL_RIGHT_MARGIN)-scroll, 0, (SCROLL_RIGHT_MARGIN)-scroll, 127);
+	for (i = 0; i < TrackedPeakCount; i++)
+	{
+		const TrackedPeak_t *pPeak = &TrackedPeaks[i];
 
-	for (uint8_t i = 0; i < 127; i++)
+		if (pPeak->Age == 0 && pPeak->Rssi > SquelchLevel)
+		{
+			const uint32_t Frequency = (i < RefinedPeakCount) ? RefinedPeaks[i].Frequency : FreqMin + (pPeak->Bin * CurrentFreqStep);
+
+			ACTIVITY_Record(Frequency, pPeak->Rssi, CurrentFreqStep);
+		}
+	}
+}
+
+static void FinishSweep(void)
+{
+	DrawCurrentFreq(COLOR_BLUE);
+	if (bMode)
 	{
-		uint16_t wf = (waterfall_rainbow[RssiValue[i] - RssiLow - offset]);
-		ST7735S_SendU16(wf); // write to screen using waterfall color from palette
+		DrawBatteryLevel();
+	}
+	else
+	{
+		scroll_waterfall();
 	}
 
-	ST7735S_SetPixel(54, CurrentFreqIndex_old, COLOR_BACKGROUND);
-	ST7735S_SetPixel(53, CurrentFreqIndex_old, COLOR_BACKGROUND);
-	ST7735S_SetPixel(52, CurrentFreqIndex_old, COLOR_BACKGROUND);
+	ACTIVITY_Flush(false);
+	StartSweep();
+}
 
-	CurrentFreqIndex_old = CurrentFreqIndex;
+static void EndSweep(void)
+{
+	CheckSnapshot();
 
-	ST7735S_SetPixel(54, CurrentFreqIndex, COLOR_GREY);
-	ST7735S_SetPixel(53, CurrentFreqIndex, COLOR_GREY);
-	ST7735S_SetPixel(52, CurrentFreqIndex, COLOR_GREY);
+#ifdef ENABLE_SPECTRUM_STREAM
+	if (bStreaming && !UART_IsRunning)
+	{
+		SendSweep(GetSweepWidth());
+	}
+#endif
+
+	if (bMode)
+	{
+		// Draw a yellow circle at the spectrum peak.
+
+		DISPLAY_drawCircle(CurrentFreqIndex_old, (pixelold[CurrentFreqIndex_old] + SPECTRUM_Y), 3, COLOR_BACKGROUND);
+
+		CurrentFreqIndex_old = CurrentFreqIndex;
+		DISPLAY_drawCircle(CurrentFreqIndex, (pixelnew[CurrentFreqIndex] + SPECTRUM_Y), 3, COLOR_RGB(255, 255, 0));
+
+		DrawPeakMarkers();
+	}
+
+	if (bResetSquelch)
+	{
+		bResetSquelch = FALSE;
+		SquelchLevel = RssiHigh + 5;
+	}
+
+	RecordPeaks();
+	if (RssiValue[CurrentFreqIndex] > SquelchLevel)
+	{
+		ACTIVITY_Record(CurrentFreq, RssiValue[CurrentFreqIndex], CurrentFreqStep);
+		BK4819_set_rf_frequency(CurrentFreq, TRUE);
+		DELAY_WaitUS(CurrentScanDelay);
+		bRXMode = TRUE;
+		Spectrum_StartAudio();
+		return;
+	}
+
+	FinishSweep();
 }
 
-void show_waterfall(void)
+// One RX poll per step, the signal is monitored until it drops below the squelch level.
+static void StepRX(void)
 {
-	uint32_t FreqToCheck;
-	CurrentFreqIndex = 0;
-	CurrentFreqIndex_old = 0;
-	CurrentFreq = FreqMin;
-	bResetSquelch = TRUE;
-	bRestartScan = FALSE;
+	RssiValue[CurrentFreqIndex] = BK4819_GetRSSI();
+	CheckSnapshot();
+	DrawCurrentFreq(COLOR_GREEN);
+	DELAY_WaitUS(CurrentScanDelay);
 
-	scroll = 0;
+	if (RssiValue[CurrentFreqIndex] <= SquelchLevel)
+	{
+		RADIO_EndAudio();
+		bRXMode = FALSE;
+		FinishSweep();
+	}
+	else
+	{
+		ACTIVITY_Record(CurrentFreq, RssiValue[CurrentFreqIndex], CurrentFreqStep);
+	}
+}
 
-	DrawLabels();
+// The refine phase starts from the strongest tracked peaks.
+static void FindPeaks(void)
+{
+	uint8_t i;
 
-	ST7735S_defineScrollArea(SCROLL_LEFT_MARGIN, SCROLL_RIGHT_MARGIN);
+	RefinedPeakCount = (TrackedPeakCount < REFINE_PEAKS) ? TrackedPeakCount : REFINE_PEAKS;
+	for (i = 0; i < RefinedPeakCount; i++)
+	{
+		RefinedPeaks[i].Frequency = FreqMin + (TrackedPeaks[i].Bin * CurrentFreqStep);
+		RefinedPeaks[i].Rssi = TrackedPeaks[i].Rssi;
+		RefinedPeaks[i].Bin = TrackedPeaks[i].Bin;
+	}
+}
+
+static void StartRefinePeak(void)
+{
+	RefinedPeak_t *pPeak = &RefinedPeaks[RefinePeakIndex];
+
+	FreqToCheck = pPeak->Frequency - CurrentFreqStep;
+	pPeak->Rssi = 0;
+	RefinePoint = 0;
+}
+
+// SelectPeak() left the receiver on the coarse bin of the selected or strongest peak, it moves
+// to the refined frequency of that peak.
+static void FinishRefine(void)
+{
+	const uint8_t Index = PeakSelect ? PeakSelect - 1 : 0;
+
+	bRefining = FALSE;
+	if (!bHold && Index < RefinedPeakCount && CurrentFreqIndex == RefinedPeaks[Index].Bin)
+	{
+		CurrentFreq = RefinedPeaks[Index].Frequency;
+	}
+	if (bMode)
+	{
+		DrawSelectedPeak();
+	}
+	EndSweep();
+}
+
+// REFINE_PEAKS * REFINE_POINTS extra measurements per sweep, a few percent of
+// what a sweep of the whole span at the fine step would take.
+static void StartRefine(void)
+{
+	FindPeaks();
+	RefineStep = CurrentFreqStep / REFINE_DIVIDER;
+	if (!RefineStep)
+	{
+		RefineStep = 1;
+	}
+	RefinePeakIndex = 0;
+	if (!RefinedPeakCount)
+	{
+		FinishRefine();
+		return;
+	}
+	bRefining = TRUE;
+	StartRefinePeak();
+}
 
-	while (1)
+static void StepRefine(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < SPECTRUM_BINS_PER_STEP; i++)
 	{
-		FreqToCheck = FreqMin;
-		bRestartScan = TRUE;
+		RefinedPeak_t *pPeak = &RefinedPeaks[RefinePeakIndex];
+		uint16_t Rssi;
+
+		if (bRestartScan)
+		{
+			StartSweep();
+			return;
+		}
+
+		BK4819_set_rf_frequency(FreqToCheck, true);
+		DELAY_WaitUS(CurrentScanDelay);
+		Rssi = BK4819_GetRSSI();
+		if (Rssi > pPeak->Rssi)
+		{
+			pPeak->Rssi = Rssi;
+			pPeak->Frequency = FreqToCheck;
+		}
+		FreqToCheck += RefineStep;
 
-		for (uint8_t i = WATERFALL_LEFT_MARGIN; i < H_WATERFALL_WIDTH - WATERFALL_RIGHT_MARGIN; i++)
+		if (++RefinePoint == REFINE_POINTS)
 		{
-			if (bRestartScan)
+			if (++RefinePeakIndex == RefinedPeakCount)
 			{
-				bRestartScan = FALSE;
-				RssiLow = 330;
-				RssiHigh = 72;
-				i = 0;
+				FinishRefine();
+				return;
 			}
+			StartRefinePeak();
+		}
+	}
+}
 
-			BK4819_set_rf_frequency(FreqToCheck, true); // set the VCO/PLL
+// The receiver follows the selected tracked peak, or else the strongest peak seen in this sweep,
+// so a new signal is preferred over one that has gone quiet.
+static void SelectPeak(void)
+{
+	const TrackedPeak_t *pPeak;
 
-			DELAY_WaitUS(CurrentScanDelay + 500); // waterfall loop needs more delay than the spectrum one so the +500us.
+	if (bHold || !TrackedPeakCount)
+	{
+		return;
+	}
+	if (PeakSelect)
+	{
+		if (PeakSelect > TrackedPeakCount)
+		{
+			return;
+		}
+		pPeak = &TrackedPeaks[PeakSelect - 1];
+	}
+	else
+	{
+		pPeak = &TrackedPeaks[0];
+		if (pPeak->Age)
+		{
+			return;
+		}
+	}
+	CurrentFreqIndex = pPeak->Bin;
+	CurrentFreq = FreqMin + (pPeak->Bin * CurrentFreqStep);
+}
+
+static void SweepDone(void)
+{
+	TrackFloor = RssiLow;
+	SortTrackedPeaks();
+	SelectPeak();
+	StartRefine();
+}
+
+// Progressive sweep: pass 0 measures every PROGRESSIVE_STRIDE-th bin, each following pass the bins
+// halfway between the ones already measured, so the whole span is on screen after the first passes.
+// Passes alternate direction, the PLL never jumps by more than PROGRESSIVE_STRIDE bins.
+
+static uint8_t GetProgressiveStride(void)
+{
+	return PROGRESSIVE_STRIDE >> ProgressivePass;
+}
+
+static uint8_t GetProgressiveCount(uint8_t Width)
+{
+	const uint8_t Stride = GetProgressiveStride();
+
+	if (!ProgressivePass)
+	{
+		return (Width + Stride - 1) / Stride;
+	}
+
+	return ((Width + Stride - 1) / Stride) / 2;
+}
+
+static uint8_t GetProgressiveBin(uint8_t Width)
+{
+	const uint8_t Stride = GetProgressiveStride();
+	uint8_t k = SweepIndex;
+
+	if (ProgressivePass & 1)
+	{
+		k = GetProgressiveCount(Width) - 1 - k;
+	}
+	if (!ProgressivePass)
+	{
+		return k * Stride;
+	}
+
+	return ((2 * k) + 1) * Stride;
+}
+
+#ifdef UART_DEBUG
+// SMOOTH_Trace() in CPU cycles, reported every SMOOTH_REPORT traces
+#define SMOOTH_REPORT 32
+
+static DELAY_Cycles_t SmoothCycles;
+#endif
+
+static void SmoothTrace(uint8_t Width)
+{
+#ifdef UART_DEBUG
+	const uint32_t Start = DELAY_StartCycles();
+
+	SMOOTH_Trace(pixelnew + SPECTRUM_LEFT_MARGIN, Width - SPECTRUM_LEFT_MARGIN);
+	DELAY_CountCycles(&SmoothCycles, Start);
+	if (SmoothCycles.Count == SMOOTH_REPORT)
+	{
+		UART_printf("Smooth: %u traces of %u points, %lu cycles average, %lu max\r\n",
+			SmoothCycles.Count,
+			Width - SPECTRUM_LEFT_MARGIN,
+			(unsigned long)(SmoothCycles.Sum / SmoothCycles.Count),
+			(unsigned long)SmoothCycles.Max);
+		SmoothCycles.Sum = 0;
+		SmoothCycles.Max = 0;
+		SmoothCycles.Count = 0;
+	}
+#else
+	SMOOTH_Trace(pixelnew + SPECTRUM_LEFT_MARGIN, Width - SPECTRUM_LEFT_MARGIN);
+#endif
+}
+
+// Bins not measured yet in this sweep are linearly interpolated from the measured ones around them.
+static void RedrawProgressiveTrace(uint8_t Width)
+{
+	const uint8_t Stride = GetProgressiveStride();
+	uint8_t i;
 
-			RssiValue[i] = BK4819_GetRSSI();
+	if (Stride == 1)
+	{
+		SmoothTrace(Width);
+	}
+	for (i = SPECTRUM_LEFT_MARGIN; i < Width; i++)
+	{
+		const uint8_t Left = i - (i % Stride);
+		const uint8_t Right = Left + Stride;
 
-			if (RssiValue[i] < RssiLow)
+		if (i != Left)
+		{
+			if (Right < Width)
 			{
-				RssiLow = RssiValue[i];
+				pixelnew[i] = pixelnew[Left] + ((((int16_t)pixelnew[Right] - (int16_t)pixelnew[Left]) * (i - Left)) / Stride);
 			}
-			else if (RssiValue[i] > RssiHigh)
+			else
 			{
-				RssiHigh = RssiValue[i];
+				pixelnew[i] = pixelnew[Left];
 			}
+		}
+		DrawSpectrumColumn(i);
+	}
+}
+
+static void StepProgressive(void)
+{
+	const uint8_t Width = GetSweepWidth();
+	uint8_t i, Bin;
+
+	for (i = 0; i < SPECTRUM_BINS_PER_STEP; i++)
+	{
+		if (bRestartScan)
+		{
+			StartSweep();
+		}
 
-			if (RssiValue[i] > RssiValue[CurrentFreqIndex] && !bHold)
+		Bin = GetProgressiveBin(Width);
+		FreqToCheck = FreqMin + (Bin * CurrentFreqStep);
+		BK4819_set_rf_frequency(FreqToCheck, true);
+		DELAY_WaitUS(CurrentScanDelay);
+		FreqToCheck += CurrentFreqStep;
+		ReadSpectrumBin(SPECTRUM_LEFT_MARGIN + Bin);
+
+		if (++SweepIndex == GetProgressiveCount(Width))
+		{
+			RedrawProgressiveTrace(Width);
+			SweepIndex = 0;
+			if (GetProgressiveStride() == 1)
 			{
-				CurrentFreqIndex = i;
-				CurrentFreq = FreqToCheck;
+				ProgressivePass = 0;
+				SweepDone();
+				return;
 			}
-
-			FreqToCheck += CurrentFreqStep;
+			ProgressivePass++;
 		}
+	}
+}
+
+static void StepSweep(void)
+{
+	const uint8_t Width = GetSweepWidth();
+	uint8_t i;
 
-		if (bResetSquelch)
+	for (i = 0; i < SPECTRUM_BINS_PER_STEP && SweepIndex < Width; i++)
+	{
+		if (bRestartScan)
+		{
+			StartSweep();
+		}
+		if (bMode)
+		{
+			MeasureSpectrumBin(SPECTRUM_LEFT_MARGIN + SweepIndex);
+		}
+		else
 		{
-			bResetSquelch = FALSE;
-			SquelchLevel = RssiHigh + 5;
+			MeasureWaterfallBin(WATERFALL_LEFT_MARGIN + SweepIndex);
 		}
+		SweepIndex++;
+	}
 
-		if (RssiValue[CurrentFreqIndex] > SquelchLevel)
+	if (SweepIndex >= Width)
+	{
+		if (bMode)
 		{
-			BK4819_set_rf_frequency(CurrentFreq, TRUE);
-			DELAY_WaitUS(CurrentScanDelay);
-			RunRX();
+			SmoothTrace(Width);
 		}
+		SweepDone();
+	}
+}
 
-		DrawCurrentFreq(COLOR_BLUE);
-		scroll_waterfall();
+static void DrawFindStatus(const char *pText)
+{
+	gColorForeground = COLOR_RGB(255, 255, 0);
+	if (bMode)
+	{
+		UI_DrawSmallString(104, 62, pText, 9);
+	}
+	else
+	{
+		UI_DrawSmallString(2, 50, pText, 8);
+	}
+}
+
+static void StartFindBand(void)
+{
+	gUseUhfFilter = (FindBand == 0);
+	BK4819_EnableFilter(true);
+	BK4819_EnableFrequencyScan();
+	FindStart = gTimeSinceBoot;
+	DrawFindStatus(gUseUhfFilter ? "FIND UHF " : "FIND VHF ");
+}
 
-		CheckKeys();
-		if (bExit)
+static void FinishFind(void)
+{
+	BK4819_StopFrequencyScan();
+	bFinding = FALSE;
+	SetFreqMinMax();
+	DrawLabels();
+	DrawFindStatus("         ");
+	if (bMode)
+	{
+		DrawSelectedPeak();
+	}
+	bResetSquelch = TRUE;
+	bRestartScan = TRUE;
+}
+
+// Instead of stepping across the band, the frequency scanner measures the strongest carrier
+// the front end sees, which then becomes the center of a normal sweep.
+static void StartFind(void)
+{
+	if (bRXMode)
+	{
+		RADIO_EndAudio();
+		bRXMode = FALSE;
+	}
+	bFinding = TRUE;
+	FindBand = 0;
+	StartFindBand();
+}
+
+static void StepFind(void)
+{
+	uint32_t Frequency;
+
+	if (gTimeSinceBoot - FindStart < FIND_SETTLE_MS)
+	{
+		return;
+	}
+
+	if (DETECTOR_GetScanFrequency(!gUseUhfFilter, &Frequency))
+	{
+		FreqCenter = Frequency;
+		FinishFind();
+		return;
+	}
+
+	if (gTimeSinceBoot - FindStart >= FIND_TIMEOUT_MS)
+	{
+		BK4819_StopFrequencyScan();
+		if (++FindBand == 2)
 		{
+			FinishFind();
+			return;
+		}
+		StartFindBand();
+	}
+}
+
+#ifdef ENABLE_SPECTRUM_WATCH
+static uint8_t IsWatchDue(void)
+{
+	return IsWatchEnabled() && (WatchSweeps >= WATCH_SWEEPS || gTimeSinceBoot - WatchTime >= WATCH_INTERVAL_MS);
+}
+
+// The home VFO registers are replayed instead of a full tune, so the slot costs about WATCH_DWELL_MS.
+// The sweep sets the frequency of every bin itself, the filters, tone detection and squelch
+// registers of the spectrum are restored. 0x08 is not: the only DCS code ever loaded while the
+// spectrum is open is the home VFO one.
+static void WatchHomeVfo(void)
+{
+	const bool bUseUhfFilter = gUseUhfFilter;
+	const uint16_t Bandwidth = BK4819_ReadRegister(0x43);
+	CSS_Registers_t Css;
+	BK4819_Squelch_t Squelch;
+	uint8_t i;
+
+	Css.Control = BK4819_ReadRegister(0x51);
+	Css.Frequency = BK4819_ReadRegister(0x07);
+	Css.Code[0] = 0;
+	Css.Code[1] = 0;
+	Squelch.Glitch[0] = BK4819_ReadRegister(0x4D);
+	Squelch.Glitch[1] = BK4819_ReadRegister(0x4E);
+	Squelch.Noise = BK4819_ReadRegister(0x4F);
+	Squelch.Rssi = BK4819_ReadRegister(0x78);
+
+	WatchSweeps = 0;
+	WatchTime = gTimeSinceBoot;
+
+	RADIO_FastTune(&HomeTune);
+	for (i = 0; i < WATCH_DWELL_MS; i++)
+	{
+		DELAY_WaitMS(1);
+		if (BK4819_CheckSquelchLink())
+		{ // StopSpectrum() tunes the home VFO properly and the incoming task takes over
+			bExit = TRUE;
 			return;
 		}
 	}
+
+	gUseUhfFilter = bUseUhfFilter;
+	BK4819_EnableFilter(bFilterEnabled);
+	BK4819_WriteRegister(0x43, Bandwidth);
+	CSS_SetRegisters(&Css);
+	BK4819_SetSquelch(&Squelch);
+}
+#endif
+
+static void StartSpectrum(void)
+{
+	CurrentFreqIndex = 0;
+	CurrentFreqIndex_old = 0;
+	CurrentFreq = FreqMin;
+	bResetSquelch = TRUE;
+	y1_old_minus = 0;
+	y1_new_minus = 0;
+
+	UI_DrawStatusIcon(139, ICON_BATTERY, true, COLOR_FOREGROUND);
+	UI_DrawBattery(false);
+	LastBatteryVoltage = gBatteryVoltage;
+
+	RefinedPeakCount = 0;
+	TrackFloor = 330;
+	DrawLabels();
+	DrawSelectedPeak();
+	StartSweep();
+}
+
+static void StartWaterfall(void)
+{
+	CurrentFreqIndex = 0;
+	CurrentFreqIndex_old = 0;
+	CurrentFreq = FreqMin;
+	bResetSquelch = TRUE;
+
+	scroll = 0;
+
+	DrawLabels();
+
+	ST7735S_defineScrollArea(SCROLL_LEFT_MARGIN, SCROLL_RIGHT_MARGIN);
+	StartSweep();
 }
 
 void APP_Spectrum(void)
@@ -933,6 +1820,7 @@ void APP_Spectrum(void)
 
 	bExit = FALSE;
 	bRXMode = FALSE;
+	bSnapshotRequested = FALSE;
 
 	FreqCenter = gVfoState[gSettings.CurrentVfo].RX.Frequency;
 	bNarrow = gVfoState[gSettings.CurrentVfo].bIsNarrow;
@@ -946,6 +1834,14 @@ void APP_Spectrum(void)
 	SquelchLevel = 0;
 	CurrentScanDelay = 1000;
 
+	RADIO_CancelMode();
+
+#ifdef ENABLE_SPECTRUM_WATCH
+	RADIO_PrepareFastTune(&gVfoState[gSettings.CurrentVfo], &HomeTune);
+	WatchTime = gTimeSinceBoot;
+	WatchSweeps = 0;
+#endif
+
 	SetStepCount();
 	SetFreqMinMax();
 
@@ -958,9 +1854,68 @@ void APP_Spectrum(void)
 
 	DrawLabels();
 
-	show_spectrum();
+	StartSpectrum();
+
+	gSpectrumMode = true;
+}
 
-	StopSpectrum();
+void SPECTRUM_Step(void)
+{
+	CheckKeys();
+	if (bExit)
+	{
+		if (bRXMode)
+		{
+			RADIO_EndAudio();
+			bRXMode = FALSE;
+		}
+		if (bFinding)
+		{
+			BK4819_StopFrequencyScan();
+			bFinding = FALSE;
+		}
+		gSpectrumMode = false;
+		ACTIVITY_Flush(true);
+		StopSpectrum();
+		return;
+	}
+
+	if (bRXMode)
+	{
+		StepRX();
+	}
+	else if (bFinding)
+	{
+		StepFind();
+	}
+#ifdef ENABLE_SPECTRUM_WATCH
+	else if (IsWatchDue())
+	{
+		WatchHomeVfo();
+	}
+#endif
+	else if (bRefining)
+	{
+		StepRefine();
+	}
+	else if (bMode && bProgressive)
+	{
+		StepProgressive();
+	}
+	else
+	{
+		StepSweep();
+	}
+}
+
+void SPECTRUM_Exit(void)
+{
+	bExit = TRUE;
+}
+
+void SPECTRUM_SaveSnapshot(void)
+{
+	bSnapshotRequested = TRUE;
 }
 
 //---------------------------------------------------------------------------------------------
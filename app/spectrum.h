@@ -27,5 +27,8 @@ enum
 };
 
 void APP_Spectrum(void);
+void SPECTRUM_Step(void);
+void SPECTRUM_Exit(void);
+void SPECTRUM_SaveSnapshot(void);
 
 #endif
\ No newline at end of file
@@ -14,19 +14,29 @@
  *     limitations under the License.
  */
 
+#include <string.h>
+#ifdef ENABLE_SPECTRUM
+	#include "app/activity.h"
+	#include "app/snapshot.h"
+#endif
 #include "app/uart.h"
 #include "bsp/gpio.h"
 #include "driver/pins.h"
 #include "driver/serial-flash.h"
 #include "driver/uart.h"
+#include "radio/channels.h"
 #include "radio/hardware.h"
+#include "radio/scanlog.h"
 #include "radio/settings.h"
+#include "radio/stats.h"
 
 static uint8_t Buffer[256];
 static uint8_t BufferLength;
 static uint8_t Region;
 static bool bFlashing;
 static uint8_t g_Unused;
+// Scan log replies are sent in the background, Buffer keeps receiving meanwhile
+static uint8_t LogReply[132];
 
 uint16_t UART_Timer;
 bool UART_IsRunning;
@@ -43,6 +53,29 @@ static uint8_t CalcSum(const uint8_t *pBytes, uint8_t Size)
 	return Sum;
 }
 
+// Sends the 128 data bytes at Buffer + 3 as the reply to Command.
+static void SendReply(uint8_t Command, uint8_t Hi, uint8_t Lo)
+{
+	Buffer[0] = Command;
+	Buffer[1] = Hi;
+	Buffer[2] = Lo;
+	Buffer[131] = CalcSum(Buffer, 0x83);
+	UART_Send(Buffer, 132);
+}
+
+// Replies with a 128 byte block of a RAM image, or 0xFF past its end.
+static void SendRamBlock(uint8_t Command, uint8_t Hi, uint8_t Lo, const void *pImage, uint16_t Size)
+{
+	const uint16_t Block = (Hi << 8) | Lo;
+
+	if (Block >= Size / 128) {
+		UART_SendByte(0xFF);
+		return;
+	}
+	memcpy(Buffer + 3, (const uint8_t *)pImage + (Block * 128), 128);
+	SendReply(Command, Hi, Lo);
+}
+
 static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 {
 	uint16_t Count = 0;
@@ -52,12 +85,71 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 
 	Block = (Hi << 8) | Lo;
 	if (Command == 0x52) {
-		Buffer[0] = 0x52;
-		Buffer[1] = Hi;
-		Buffer[2] = Lo;
 		SFLASH_Read(Buffer + 3, Block * 128, 128);
-		Buffer[131] = CalcSum(Buffer, 0x83);
-		UART_Send(Buffer, 132);
+		SendReply(Command, Hi, Lo);
+		return;
+	}
+	if (Command == 0x53) {
+#ifdef ENABLE_SPECTRUM
+		SendRamBlock(Command, Hi, Lo, &gActivityLog, sizeof(gActivityLog));
+#else
+		UART_SendByte(0xFF);
+#endif
+		return;
+	}
+
+	if (Command == 0x54) {
+#ifdef ENABLE_SPECTRUM
+		// Snapshot ring, SNAPSHOT_SLOT_SIZE / 128 blocks per slot with the header in the first one.
+		if (Block >= SNAPSHOT_SLOTS * (SNAPSHOT_SLOT_SIZE / 128)) {
+			UART_SendByte(0xFF);
+			return;
+		}
+		SFLASH_Read(Buffer + 3, SNAPSHOT_GetAddress(0) + (Block * 128), 128);
+		SendReply(Command, Hi, Lo);
+#else
+		UART_SendByte(0xFF);
+#endif
+		return;
+	}
+
+	if (Command == 0x55) {
+		uint32_t Hits;
+		uint32_t Misses;
+
+		// Channel cache counters: hits, misses, cache size
+		if (Block != 0) {
+			UART_SendByte(0xFF);
+			return;
+		}
+		memset(Buffer + 3, 0, 128);
+		Buffer[11] = CHANNELS_GetCacheStats(&Hits, &Misses);
+		memcpy(Buffer + 3, &Hits, sizeof(Hits));
+		memcpy(Buffer + 7, &Misses, sizeof(Misses));
+		SendReply(Command, Hi, Lo);
+		return;
+	}
+
+	if (Command == 0x56) {
+		SendRamBlock(Command, Hi, Lo, &gStatsLog, sizeof(gStatsLog));
+		return;
+	}
+
+	if (Command == 0x57) {
+		// A request while the previous reply is still going out is dropped, the reply is not
+		// cut off.
+		if (UART_IsSendingAsync()) {
+			return;
+		}
+		if (!SCANLOG_ReadBlock(Block, LogReply + 3)) {
+			UART_SendByte(0xFF);
+			return;
+		}
+		LogReply[0] = 0x57;
+		LogReply[1] = Hi;
+		LogReply[2] = Lo;
+		LogReply[131] = CalcSum(LogReply, 0x83);
+		UART_SendAsync(LogReply, sizeof(LogReply));
 		return;
 	}
 
@@ -112,6 +204,10 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 		for (i = 0; i < Count; i++) {
 			SFLASH_Erase(Page + i);
 		}
+		if (Region == 2) {
+			// New channels, the index is rebuilt after the reboot
+			CHANNELS_InvalidateIndex();
+		}
 	}
 
 	SFLASH_Write(Buffer + 3, (Page * 4096U) + (Block * 128U), 128U);
@@ -120,6 +216,8 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 
 void HandlerUSART1(void)
 {
+	UART_HandleTx();
+
 	if (USART1->ctrl1_bit.rdbfien && USART1->sts & USART_RDBF_FLAG) {
 		uint8_t Cmd;
 
@@ -127,17 +225,20 @@ void HandlerUSART1(void)
 
 		BufferLength %= 256;
 		Cmd = Buffer[0];
-		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52) {
+		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52 && Cmd != 0x53 && Cmd != 0x54 && Cmd != 0x55 && Cmd != 0x56 && Cmd != 0x57) {
 			UART_IsRunning = false;
 			UART_Timer = 0;
 			UART_SendByte(0xFF);
 			BufferLength = 0;
 		} else {
-			if ((Cmd == 0x35 && BufferLength == 5) || (Cmd == 0x52 && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
+			if ((Cmd == 0x35 && BufferLength == 5) || ((Cmd == 0x52 || Cmd == 0x53 || Cmd == 0x54 || Cmd == 0x55 || Cmd == 0x56 || Cmd == 0x57) && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
 				if (CalcSum(Buffer, BufferLength - 1) == Buffer[BufferLength - 1]) {
-					gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_IsRunning = true;
-					UART_Timer = 1000;
+					// The scan log is read while the main loop and the scanner keep running
+					if (Cmd != 0x57) {
+						gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_RED);
+						UART_IsRunning = true;
+						UART_Timer = 1000;
+					}
 					if (Cmd == 0x35) {
 						if (Buffer[3] == 16) {
 							g_Unused = 0;
@@ -30,6 +30,10 @@ enum {
 	GPIO_FILTER_UNKWOWN = 1U << 7,
 };
 
+#ifdef UART_DEBUG
+uint32_t gBK4819_Transactions;
+#endif
+
 static const uint8_t gSquelchGlitchLevel[11] = {
 	0x20,
 	0x20,
@@ -183,6 +187,9 @@ uint16_t BK4819_ReadRegister(uint8_t Reg)
 {
 	uint16_t Data;
 
+#ifdef UART_DEBUG
+	gBK4819_Transactions++;
+#endif
 	TMR1->ctrl1_bit.tmren = FALSE;
 
 	SDA_SetOutput();
@@ -203,6 +210,9 @@ uint16_t BK4819_ReadRegister(uint8_t Reg)
 
 void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
 {
+#ifdef UART_DEBUG
+	gBK4819_Transactions++;
+#endif
 	TMR1->ctrl1_bit.tmren = FALSE;
 
 	SDA_SetOutput();
@@ -224,6 +234,11 @@ uint16_t BK4819_GetRSSI(void)
 	return BK4819_ReadRegister(0x67) & 0x01FF;
 }
 
+uint8_t BK4819_GetNoise(void)
+{
+	return BK4819_ReadRegister(0x65) & 0x007F;
+}
+
 void BK4819_Init(void)
 {
 	BK4819_WriteRegister(0x00, 0x8000);
@@ -315,45 +330,69 @@ void BK4819_SetFrequency(uint32_t Frequency)
 	BK4819_WriteRegister(0x39, (Frequency >> 16) & 0xFFFFU);
 }
 
-void BK4819_SetSquelchGlitch(bool bIsNarrow)
+static uint16_t GetSquelchGlitch(bool bIsNarrow, uint16_t Offset)
 {
 	if (bIsNarrow) {
-		BK4819_WriteRegister(0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0x9FFF);
-		BK4819_WriteRegister(0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFE);
-	} else {
-		BK4819_WriteRegister(0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0xA000);
-		BK4819_WriteRegister(0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFF);
+		return gSquelchGlitchLevel[gSettings.Squelch] + Offset - 1;
 	}
+
+	return gSquelchGlitchLevel[gSettings.Squelch] + Offset;
 }
 
-void BK4819_SetSquelchNoise(bool bIsNarrow)
+static uint16_t GetSquelchNoise(bool bIsNarrow)
 {
 	uint8_t Level;
-	uint16_t Value;
 
 	Level = gSquelchNoiseLevel[gSettings.Squelch];
 	if (bIsNarrow) {
-		Value = ((gSquelchNoiseNarrow + 12 + Level) << 8) | (gSquelchNoiseNarrow + 6 + Level);
-	} else {
-		Value = ((gSquelchNoiseWide   + 12 + Level) << 8) | (gSquelchNoiseWide   - 6 + Level);
+		return ((gSquelchNoiseNarrow + 12 + Level) << 8) | (gSquelchNoiseNarrow + 6 + Level);
 	}
 
-	BK4819_WriteRegister(0x4F, Value);
+	return ((gSquelchNoiseWide   + 12 + Level) << 8) | (gSquelchNoiseWide   - 6 + Level);
 }
 
-void BK4819_SetSquelchRSSI(bool bIsNarrow)
+static uint16_t GetSquelchRSSI(bool bIsNarrow)
 {
 	uint8_t Level;
-	uint16_t Value;
 
 	Level = gSquelchRssiLevel[gSettings.Squelch];
 	if (bIsNarrow) {
-		Value = ((gSquelchRSSINarrow - 8 + Level) << 8) | (gSquelchRSSINarrow - 14 + Level);
-	} else {
-		Value = ((gSquelchRSSIWide   - 8 + Level) << 8) | (gSquelchRSSIWide   - 14 + Level);
+		return ((gSquelchRSSINarrow - 8 + Level) << 8) | (gSquelchRSSINarrow - 14 + Level);
 	}
 
-	BK4819_WriteRegister(0x78, Value);
+	return ((gSquelchRSSIWide   - 8 + Level) << 8) | (gSquelchRSSIWide   - 14 + Level);
+}
+
+void BK4819_SetSquelchGlitch(bool bIsNarrow)
+{
+	BK4819_WriteRegister(0x4D, GetSquelchGlitch(bIsNarrow, 0xA000));
+	BK4819_WriteRegister(0x4E, GetSquelchGlitch(bIsNarrow, 0x4DFF));
+}
+
+void BK4819_SetSquelchNoise(bool bIsNarrow)
+{
+	BK4819_WriteRegister(0x4F, GetSquelchNoise(bIsNarrow));
+}
+
+void BK4819_SetSquelchRSSI(bool bIsNarrow)
+{
+	BK4819_WriteRegister(0x78, GetSquelchRSSI(bIsNarrow));
+}
+
+void BK4819_GetSquelch(BK4819_Squelch_t *pSquelch, bool bIsNarrow)
+{
+	pSquelch->Glitch[0] = GetSquelchGlitch(bIsNarrow, 0xA000);
+	pSquelch->Glitch[1] = GetSquelchGlitch(bIsNarrow, 0x4DFF);
+	pSquelch->Noise = GetSquelchNoise(bIsNarrow);
+	pSquelch->Rssi = GetSquelchRSSI(bIsNarrow);
+}
+
+void BK4819_SetSquelch(const BK4819_Squelch_t *pSquelch)
+{
+	BK4819_WriteRegister(0x4D, pSquelch->Glitch[0]);
+	BK4819_WriteRegister(0x4E, pSquelch->Glitch[1]);
+	BK4819_WriteRegister(0x4F, pSquelch->Noise);
+	BK4819_WriteRegister(0x78, pSquelch->Rssi);
 }
 
 void BK4819_SetFilterBandwidth(bool bIsNarrow)
@@ -663,9 +702,14 @@ void BK4819_EnableTX(bool bUseMic)
 	}
 }
 
-void BK4819_StartFrequencyScan(void)
+void BK4819_EnableFrequencyScan(void)
 {
 	BK4819_WriteRegister(0x32, 0x0B01);
+}
+
+void BK4819_StartFrequencyScan(void)
+{
+	BK4819_EnableFrequencyScan();
 	DELAY_WaitMS(200);
 }
 
@@ -681,7 +725,6 @@ void BK4819_DisableAutoCssBW(void)
 	BK4819_EnableRX();
 }
 
-#ifdef ENABLE_SPECTRUM
 void BK4819_set_rf_frequency(const uint32_t frequency, const bool trigger_update)
 {
 	BK4819_WriteRegister(0x38, (frequency >> 0) & 0xFFFF);
@@ -694,4 +737,3 @@ void BK4819_set_rf_frequency(const uint32_t frequency, const bool trigger_update
 		BK4819_WriteRegister(0x30, reg);
 	}
 }
-#endif
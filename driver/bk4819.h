@@ -37,9 +37,19 @@ enum BK4819_AF_Type_t {
 
 typedef enum BK4819_AF_Type_t BK4819_AF_Type_t;
 
+typedef struct {
+	uint16_t Glitch[2];	// 0x4D, 0x4E
+	uint16_t Noise;		// 0x4F
+	uint16_t Rssi;		// 0x78
+} BK4819_Squelch_t;
+
 void OpenAudio(bool bIsNarrow, uint8_t gModulationType);
+#ifdef UART_DEBUG
+	extern uint32_t gBK4819_Transactions;
+#endif
 uint16_t BK4819_ReadRegister(uint8_t Reg);
 uint16_t BK4819_GetRSSI();
+uint8_t BK4819_GetNoise(void);
 void BK4819_WriteRegister(uint8_t Reg, uint16_t Data);
 
 void BK4819_Init(void);
@@ -50,6 +60,8 @@ void BK4819_SetFrequency(uint32_t Frequency);
 void BK4819_SetSquelchGlitch(bool bIsNarrow);
 void BK4819_SetSquelchNoise(bool bIsNarrow);
 void BK4819_SetSquelchRSSI(bool bIsNarrow);
+void BK4819_GetSquelch(BK4819_Squelch_t *pSquelch, bool bIsNarrow);
+void BK4819_SetSquelch(const BK4819_Squelch_t *pSquelch);
 void BK4819_ToggleAGCMode(bool bAuto);
 void BK4819_RestoreGainSettings();
 void BK4819_SetFilterBandwidth(bool bIsNarrow);
@@ -70,12 +82,11 @@ void BK4819_SetupPowerAmplifier(uint8_t Bias);
 void BK4819_EnableRfTxDeviation(void);
 void BK4819_SetMicSensitivityTuning(void);
 void BK4819_EnableTX(bool bUseMic);
+void BK4819_EnableFrequencyScan(void);
 void BK4819_StartFrequencyScan(void);
 void BK4819_StopFrequencyScan(void);
 void BK4819_DisableAutoCssBW(void);
-#ifdef ENABLE_SPECTRUM
 void BK4819_set_rf_frequency(const uint32_t frequency, const bool trigger_update);
-#endif
 
 #endif
 
@@ -81,3 +81,27 @@ void DELAY_WaitMS(uint16_t Delay)
 	WaitMS(Delay % 500);
 }
 
+#ifdef UART_DEBUG
+uint32_t DELAY_StartCycles(void)
+{
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	return DWT->CYCCNT;
+}
+
+void DELAY_CountCycles(DELAY_Cycles_t *pCycles, uint32_t Start)
+{
+	const uint32_t Cycles = DWT->CYCCNT - Start;
+
+	pCycles->Sum += Cycles;
+	pCycles->Count++;
+	if (pCycles->Max < Cycles) {
+		pCycles->Max = Cycles;
+	}
+}
+#endif
+
@@ -23,5 +23,17 @@ void DELAY_Init(void);
 void DELAY_WaitUS(uint32_t Delay);
 void DELAY_WaitMS(uint16_t Delay);
 
+#ifdef UART_DEBUG
+// Core cycle totals of a timed section, for the debug reports
+typedef struct {
+	uint32_t Sum;
+	uint32_t Max;
+	uint16_t Count;
+} DELAY_Cycles_t;
+
+uint32_t DELAY_StartCycles(void);
+void DELAY_CountCycles(DELAY_Cycles_t *pCycles, uint32_t Start);
+#endif
+
 #endif
 
@@ -20,6 +20,10 @@
 
 static bool gSPI_Lock;
 
+#ifdef UART_DEBUG
+uint32_t gSFLASH_ReadBytes;
+#endif
+
 static uint8_t Transfer(uint8_t Output)
 {
 	uint8_t Input = 0U;
@@ -111,6 +115,9 @@ void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
 	uint8_t *pBytes = (uint8_t *)pBuffer;
 	uint16_t i;
 
+#ifdef UART_DEBUG
+	gSFLASH_ReadBytes += Size;
+#endif
 	if (!gSPI_Lock) {
 		HARDWARE_EnableInterrupts(false);
 	}
@@ -19,6 +19,10 @@
 
 #include <stdint.h>
 
+#ifdef UART_DEBUG
+	extern uint32_t gSFLASH_ReadBytes;
+#endif
+
 void SFLASH_Init(void);
 void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size);
 void SFLASH_Erase(uint32_t Page);
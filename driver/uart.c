@@ -65,8 +65,23 @@ void UART_Init(uint32_t BaudRate)
 	USART1->ctrl1_bit.uen = TRUE;
 }
 
+static const uint8_t *pTxBytes;
+static volatile uint16_t TxLength;
+
 void UART_SendByte(uint8_t Data)
 {
+	if (USART1->ctrl1_bit.tdbeien) {
+		// Synchronous replies are queued after the background transfer, which is finished here.
+		USART1->ctrl1_bit.tdbeien = FALSE;
+		while (TxLength) {
+			while (!(USART1->sts & USART_TDBE_FLAG)) {
+			}
+			USART1->dt = *pTxBytes++;
+			TxLength--;
+		}
+		while (!(USART1->sts & USART_TDBE_FLAG)) {
+		}
+	}
 	USART1->dt = Data;
 	while (!(USART1->sts & USART_TDBE_FLAG)) {
 	}
@@ -82,6 +97,35 @@ void UART_Send(const void *pBuffer, uint8_t Size)
 	}
 }
 
+bool UART_SendAsync(const void *pBuffer, uint16_t Size)
+{
+	if (TxLength || !Size) {
+		return false;
+	}
+	pTxBytes = (const uint8_t *)pBuffer;
+	TxLength = Size;
+	USART1->ctrl1_bit.tdbeien = TRUE;
+
+	return true;
+}
+
+bool UART_IsSendingAsync(void)
+{
+	return TxLength != 0;
+}
+
+void UART_HandleTx(void)
+{
+	if (USART1->ctrl1_bit.tdbeien && USART1->sts & USART_TDBE_FLAG) {
+		if (TxLength) {
+			USART1->dt = *pTxBytes++;
+			TxLength--;
+		} else {
+			USART1->ctrl1_bit.tdbeien = FALSE;
+		}
+	}
+}
+
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...)
 	{
@@ -17,11 +17,16 @@
 #ifndef DRIVER_UART_H
 #define DRIVER_UART_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 void UART_Init(uint32_t BaudRate);
 void UART_SendByte(uint8_t Data);
 void UART_Send(const void *pBuffer, uint8_t Size);
+// Interrupt driven transmit, the buffer must stay valid until UART_IsSendingAsync() returns false.
+bool UART_SendAsync(const void *pBuffer, uint16_t Size);
+bool UART_IsSendingAsync(void);
+void UART_HandleTx(void);
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...);
 #endif
@@ -15,6 +15,10 @@
  */
 
 #include <at32f421.h>
+#ifdef ENABLE_SPECTRUM
+	#include "app/activity.h"
+	#include "app/snapshot.h"
+#endif
 #include "app/radio.h"
 #include "app/uart.h"
 #include "driver/bk4819.h"
@@ -26,7 +30,10 @@
 #include "misc.h"
 #include "radio/data.h"
 #include "radio/hardware.h"
+#include "radio/lockout.h"
+#include "radio/scanlog.h"
 #include "radio/settings.h"
+#include "radio/stats.h"
 #include "task/am-fix.h"
 #include "task/alarm.h"
 #include "task/battery.h"
@@ -45,6 +52,9 @@
 #include "task/scanner.h"
 #include "task/screen.h"
 #include "task/sidekeys.h"
+#ifdef ENABLE_SPECTRUM
+	#include "task/spectrum.h"
+#endif
 #include "task/timeout.h"
 #include "task/voice.h"
 #include "task/vox.h"
@@ -67,6 +77,13 @@ void Main(void)
 	DELAY_WaitMS(200);
 	HARDWARE_Init();
 	RADIO_Init();
+	STATS_Init();
+	LOCKOUT_Init();
+	SCANLOG_Init();
+#ifdef ENABLE_SPECTRUM
+	ACTIVITY_Init();
+	SNAPSHOT_Init();
+#endif
 
 	if (gSettings.DtmfState == DTMF_STATE_KILLED) {
 		DATA_ReceiverInit();
@@ -97,6 +114,9 @@ void Main(void)
 				Task_CheckNOAA();
 #endif
 				Task_LocalAlarm();
+#ifdef ENABLE_SPECTRUM
+				Task_Spectrum();
+#endif
 			}
 		} while (gSettings.DtmfState != DTMF_STATE_KILLED);
 		if (BK4819_ReadRegister(0x0C) & 0x0001U) {
@@ -26,6 +26,7 @@ bool gFrequencyDetectMode;
 bool gEnableBlink;
 bool gRedrawScreen;
 bool gScannerMode;
+bool gSpectrumMode;
 bool gSaveMode;
 bool gStartupSoundPlaying = false;
 bool gReceptionMode;
@@ -54,5 +55,5 @@ char gBigString[40];
 
 uint32_t SFLASH_Offsets[20];
 uint32_t SFLASH_FontOffsets[32];
-uint8_t gFlashBuffer[8192];
+uint8_t gFlashBuffer[8192] __attribute__((aligned(4)));
 
@@ -14,6 +14,7 @@
  *     limitations under the License.
  */
 
+#include <stddef.h>
 #include <string.h>
 #include "app/css.h"
 #include "app/fm.h"
@@ -24,7 +25,9 @@
 #include "helper/inputbox.h"
 #include "misc.h"
 #include "radio/channels.h"
+#include "radio/hardware.h"
 #include "radio/settings.h"
+#include "radio/stats.h"
 #include "ui/helper.h"
 #ifdef ENABLE_NOAA
 	#include "ui/noaa.h"
@@ -352,20 +355,728 @@ static const ChannelInfo_t gNoaaDefaultChannels[11] = {
 };
 #endif
 
+#define CHANNEL_COUNT		999
+#define CHANNEL_WORDS		((CHANNEL_COUNT + 31) / 32)
+#define CHANNEL_NONE		0xFFFF
+
+// The index is kept in flash as an image (used bitmap and the IsInscanList of every channel)
+// followed by a journal of saved channels. A save programs one journal entry, only a full
+// journal or an inconsistent image costs a rebuild from the channels.
+#define INDEX_ADDRESS		0x3D6000U
+#define INDEX_BITMAP		(INDEX_ADDRESS + 0x010U)
+#define INDEX_MASKS		(INDEX_ADDRESS + 0x100U)
+#define INDEX_JOURNAL		(INDEX_ADDRESS + 0x500U)
+#define INDEX_JOURNAL_SIZE	((0x1000U - 0x500U) / sizeof(IndexEntry_t))
+#define INDEX_MASK_CHUNK	32	// masks programmed per write while rebuilding
+#define INDEX_MAGIC		0x32584943U // "CIX2"
+
+#define INDEX_USED		0x01U
+#define INDEX_FREQ_SAME		0x40U	// the save left the frequency index as it was
+#define INDEX_PENDING		0x80U	// cleared once the channel itself has been written
+#define INDEX_GENERATION(x)	(((x) & 0x1FU) << 1)
+
+typedef struct {
+	uint32_t Magic;
+	uint32_t Generation;
+	uint32_t Commit;	// ~Generation, programmed last
+	uint8_t bFLock;
+	uint8_t Reserved[3];
+} IndexHeader_t;
+
+typedef struct {
+	uint16_t Channel;	// 0xFFFF for a free entry
+	uint8_t IsInscanList;
+	uint8_t Flags;
+} IndexEntry_t;
+
+// The memory channels sorted by RX frequency, kept in flash in two banks. A save merges the
+// current bank with the saved channel into the other one, the header is committed last. The
+// header also records the state of the channel index, anything else rebuilds it at boot. Saves
+// that keep the RX frequency and the used state of a channel leave the banks alone, their
+// journal entries are marked with INDEX_FREQ_SAME.
+#define FREQ_INDEX_ADDRESS	0x3E8000U
+#define FREQ_INDEX_BANK_SIZE	0x2000U
+#define FREQ_INDEX_MAGIC	0x31585146U // "FQX1"
+#define FREQ_INDEX_NONE		0xFF
+#define FREQ_INDEX_CHUNK	16
+
+typedef struct {
+	uint32_t Magic;
+	uint32_t Sequence;
+	uint32_t Generation;	// IndexGeneration and JournalCount at the time of writing
+	uint16_t Journal;
+	uint16_t Count;
+	uint32_t Commit;	// ~Sequence, programmed last
+	uint32_t Reserved[3];
+} FreqIndexHeader_t;
+
+typedef struct {
+	uint32_t Frequency;
+	uint16_t Channel;
+	uint16_t Reserved;
+} FreqIndexEntry_t;
+
 uint16_t gFreeChannelsCount;
 
-bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist) {
-	uint16_t startChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
-	do {
-		if (Key == KEY_UP) {
-			gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelUp(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+// One bit per memory channel, so stepping and scanning skip empty channels without reading
+// the flash. ListIndex holds the channels in any of the ListIndexLists, so a channel in several
+// merged lists is only visited once. It is rebuilt from ChannelMasks, the IsInscanList of every
+// channel, when the scanned lists change, which needs no flash access.
+static uint32_t ChannelIndex[CHANNEL_WORDS];
+static uint8_t ChannelMasks[CHANNEL_COUNT];
+static uint32_t ListIndex[CHANNEL_WORDS];
+static uint8_t ListIndexLists;
+static uint32_t IndexGeneration;
+static uint16_t JournalCount;
+static uint16_t JournalFreqEnd;	// journal length after the last save that changed the frequency index
+static uint8_t FreqBank = FREQ_INDEX_NONE;
+static uint32_t FreqSequence;
+static uint16_t FreqCount;
+
+// Decoded records of the most recently loaded channels. CacheOrder lists the slots in use from
+// the most to the least recently used, saves write through so the cache never holds stale data.
+#define CHANNEL_CACHE_SIZE	8
+
+static ChannelInfo_t CacheData[CHANNEL_CACHE_SIZE];
+static uint16_t CacheChannel[CHANNEL_CACHE_SIZE];
+static uint8_t CacheOrder[CHANNEL_CACHE_SIZE];
+static uint8_t CacheUsed;
+static uint32_t CacheHits;
+static uint32_t CacheMisses;
+
+static bool IsChannelEmpty(const ChannelInfo_t *pChannel)
+{
+	uint32_t Frequency;
+
+	if (gSettings.bFLock) {
+		Frequency = pChannel->RX.Frequency;
+		if (Frequency > 44000000) {
+			return true;
+		}
+		if (Frequency > 14600000 && Frequency < 43000000) {
+			return true;
+		}
+		if (Frequency > 13600000 && Frequency < 14400000) {
+			return true;
+		}
+		if (Frequency < 10800000) {
+			return true;
+		}
+		Frequency = pChannel->TX.Frequency;
+		if (Frequency > 44000000) {
+			return true;
+		}
+		if (Frequency > 14600000 && Frequency < 43000000) {
+			return true;
+		}
+		if (Frequency > 13600000 && Frequency < 14400000) {
+			return true;
+		}
+		if (Frequency < 10800000) {
+			return true;
+		}
+	}
+
+	return pChannel->Available;
+}
+
+// Scan laps in most active first order: the most active channels of the statistics, then the
+// others in channel order. The ranking is taken again at the start of every lap.
+#define ACTIVE_FIRST_COUNT	8
+
+static uint16_t ActiveOrder[ACTIVE_FIRST_COUNT];
+static uint8_t ActiveCount;
+static uint8_t ActivePos;
+static uint16_t ActiveList = 0xFFFF;
+static uint16_t LapChannel;
+static bool bLapStarted;
+
+// While the scanner dwells, the channel of the next hop is found, its record read into the cache
+// PREFETCH_CHUNK bytes per step (flash reads run with interrupts off) and its tune descriptor
+// prepared, so the hop itself only loads registers.
+#define PREFETCH_CHUNK		8
+
+enum {
+	PREFETCH_IDLE = 0U,
+	PREFETCH_READ,
+	PREFETCH_DECODE,
+	PREFETCH_READY,
+};
+
+static ChannelInfo_t PrefetchData;
+static uint16_t PrefetchChannel = CHANNEL_NONE;
+static uint8_t PrefetchStage;
+static uint8_t PrefetchOffset;
+
+static uint8_t FindCacheEntry(uint16_t Channel)
+{
+	uint8_t i;
+
+	for (i = 0; i < CacheUsed; i++) {
+		if (CacheChannel[CacheOrder[i]] == Channel) {
+			return i;
+		}
+	}
+
+	return CHANNEL_CACHE_SIZE;
+}
+
+static void TouchCacheEntry(uint8_t Position)
+{
+	const uint8_t Slot = CacheOrder[Position];
+
+	for (; Position > 0; Position--) {
+		CacheOrder[Position] = CacheOrder[Position - 1];
+	}
+	CacheOrder[0] = Slot;
+}
+
+// Takes a free slot, or the least recently used one, for Channel and makes it the most recent.
+static ChannelInfo_t *AddCacheEntry(uint16_t Channel)
+{
+	uint8_t Position;
+	uint8_t Slot;
+
+	if (CacheUsed < CHANNEL_CACHE_SIZE) {
+		Position = CacheUsed;
+		CacheOrder[Position] = CacheUsed++;
+	} else {
+		Position = CHANNEL_CACHE_SIZE - 1;
+	}
+	Slot = CacheOrder[Position];
+	CacheChannel[Slot] = Channel;
+	TouchCacheEntry(Position);
+
+	return &CacheData[Slot];
+}
+
+static const ChannelInfo_t *GetCachedChannel(uint16_t Channel)
+{
+	const uint8_t Position = FindCacheEntry(Channel);
+	ChannelInfo_t *pData;
+
+	if (Position < CHANNEL_CACHE_SIZE) {
+		CacheHits++;
+		TouchCacheEntry(Position);
+		return &CacheData[CacheOrder[0]];
+	}
+
+	CacheMisses++;
+	pData = AddCacheEntry(Channel);
+	SFLASH_Read(pData, 0x3C2000 + (Channel * sizeof(ChannelInfo_t)), sizeof(ChannelInfo_t));
+
+	return pData;
+}
+
+static void UpdateCachedChannel(uint16_t Channel, const ChannelInfo_t *pChannel)
+{
+	const uint8_t Position = FindCacheEntry(Channel);
+
+	if (Position < CHANNEL_CACHE_SIZE) {
+		CacheData[CacheOrder[Position]] = *pChannel;
+	}
+}
+
+static bool GetIndexBit(const uint32_t *pIndex, uint16_t Channel)
+{
+	return (pIndex[Channel / 32] >> (Channel % 32)) & 1U;
+}
+
+static void SetIndexBit(uint32_t *pIndex, uint16_t Channel, bool bSet)
+{
+	if (bSet) {
+		pIndex[Channel / 32] |= 1U << (Channel % 32);
+	} else {
+		pIndex[Channel / 32] &= ~(1U << (Channel % 32));
+	}
+}
+
+static void WriteIndex(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	HARDWARE_EnableInterrupts(false);
+	SFLASH_Write(pBuffer, Address, Size);
+	HARDWARE_EnableInterrupts(true);
+}
+
+static const uint32_t *GetListIndex(void)
+{
+	uint16_t i;
+
+	if (ListIndexLists != CHANNELS_GetScanLists()) {
+		ListIndexLists = CHANNELS_GetScanLists();
+		for (i = 0; i < CHANNEL_COUNT; i++) {
+			SetIndexBit(ListIndex, i, GetIndexBit(ChannelIndex, i) && (ChannelMasks[i] & ListIndexLists));
+		}
+	}
+
+	return ListIndex;
+}
+
+static uint16_t FindChannel(const uint32_t *pIndex, uint16_t Channel, bool bUp)
+{
+	uint16_t i;
+
+	for (i = 0; i < CHANNEL_COUNT; i++) {
+		if (bUp) {
+			Channel = (Channel + 1) % CHANNEL_COUNT;
 		} else {
-			gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelDown(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+			Channel = (Channel + CHANNEL_COUNT - 1) % CHANNEL_COUNT;
 		}
-		if (gSettings.VfoChNo[gSettings.CurrentVfo] == startChannel)
-			return false;	// empty list
-	} while (OnlyFromScanlist && !((gVfoState[gSettings.CurrentVfo].IsInscanList >> gExtendedSettings.CurrentScanList) & 1));
-	RADIO_Tune(gSettings.CurrentVfo);
+		if (GetIndexBit(pIndex, Channel)) {
+			return Channel;
+		}
+	}
+
+	return CHANNEL_NONE;
+}
+
+static void StartLap(void)
+{
+	ActiveCount = STATS_GetMostActive(ActiveOrder, ACTIVE_FIRST_COUNT);
+	ActivePos = 0;
+	bLapStarted = false;
+}
+
+static bool IsActiveFirst(uint16_t Channel)
+{
+	uint8_t i;
+
+	for (i = 0; i < ActiveCount; i++) {
+		if (ActiveOrder[i] == Channel) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint16_t FindActiveFirst(const uint32_t *pIndex, bool bUp)
+{
+	const uint16_t List = gExtendedSettings.ScanAll ? 0x100U : CHANNELS_GetScanLists();
+	uint16_t Channel;
+	uint16_t Next;
+	uint8_t Lap;
+
+	if (ActiveList != List) {
+		ActiveList = List;
+		StartLap();
+	}
+
+	for (Lap = 0; Lap < 2; Lap++) {
+		while (ActivePos < ActiveCount) {
+			Next = ActiveOrder[ActivePos++];
+			if (Next < CHANNEL_COUNT && GetIndexBit(pIndex, Next)) {
+				return Next;
+			}
+		}
+		Next = bLapStarted ? LapChannel : (bUp ? CHANNEL_COUNT - 1 : 0);
+		while (1) {
+			Channel = Next;
+			Next = FindChannel(pIndex, Channel, bUp);
+			if (Next == CHANNEL_NONE) {
+				return CHANNEL_NONE;
+			}
+			if (bLapStarted && (bUp ? Next <= Channel : Next >= Channel)) {
+				break;	// wrapped, the lap is over
+			}
+			bLapStarted = true;
+			if (!IsActiveFirst(Next)) {
+				LapChannel = Next;
+				return Next;
+			}
+		}
+		StartLap();
+	}
+
+	return CHANNEL_NONE;
+}
+
+// FindActiveFirst() without moving the lap along.
+static uint16_t PeekActiveFirst(const uint32_t *pIndex, bool bUp)
+{
+	uint16_t Order[ACTIVE_FIRST_COUNT];
+	const uint8_t Count = ActiveCount;
+	const uint8_t Position = ActivePos;
+	const uint16_t List = ActiveList;
+	const uint16_t Lap = LapChannel;
+	const bool bStarted = bLapStarted;
+	uint16_t Channel;
+
+	memcpy(Order, ActiveOrder, sizeof(Order));
+	Channel = FindActiveFirst(pIndex, bUp);
+	memcpy(ActiveOrder, Order, sizeof(Order));
+	ActiveCount = Count;
+	ActivePos = Position;
+	ActiveList = List;
+	LapChannel = Lap;
+	bLapStarted = bStarted;
+
+	return Channel;
+}
+
+static void ResetPrefetch(void)
+{
+	PrefetchStage = PREFETCH_IDLE;
+	PrefetchChannel = CHANNEL_NONE;
+}
+
+static void UpdateIndex(uint16_t Channel, const ChannelInfo_t *pChannel)
+{
+	const bool bUsed = !IsChannelEmpty(pChannel);
+
+	if (Channel >= CHANNEL_COUNT) {
+		return;
+	}
+	SetIndexBit(ChannelIndex, Channel, bUsed);
+	ChannelMasks[Channel] = pChannel->IsInscanList;
+	if (ListIndexLists) {
+		SetIndexBit(ListIndex, Channel, bUsed && (pChannel->IsInscanList & ListIndexLists));
+	}
+}
+
+static void RebuildIndex(void)
+{
+	ChannelInfo_t Channel;
+	IndexHeader_t Header;
+	uint16_t i;
+
+	HARDWARE_EnableInterrupts(false);
+	SFLASH_Erase(INDEX_ADDRESS >> 12);
+	HARDWARE_EnableInterrupts(true);
+
+	for (i = 0; i < CHANNEL_COUNT; i++) {
+		SFLASH_Read(&Channel, 0x3C2000 + (i * sizeof(Channel)), sizeof(Channel));
+		SetIndexBit(ChannelIndex, i, !IsChannelEmpty(&Channel));
+		ChannelMasks[i] = Channel.IsInscanList;
+		if (i % INDEX_MASK_CHUNK == INDEX_MASK_CHUNK - 1 || i == CHANNEL_COUNT - 1) {
+			WriteIndex(ChannelMasks + i - (i % INDEX_MASK_CHUNK), INDEX_MASKS + i - (i % INDEX_MASK_CHUNK), (i % INDEX_MASK_CHUNK) + 1);
+		}
+	}
+	WriteIndex(ChannelIndex, INDEX_BITMAP, sizeof(ChannelIndex));
+
+	IndexGeneration++;
+	Header.Magic = INDEX_MAGIC;
+	Header.Generation = IndexGeneration;
+	Header.Commit = 0xFFFFFFFFU;
+	Header.bFLock = gSettings.bFLock;
+	Header.Reserved[0] = 0xFF;
+	Header.Reserved[1] = 0xFF;
+	Header.Reserved[2] = 0xFF;
+	WriteIndex(&Header, INDEX_ADDRESS, sizeof(Header));
+	Header.Commit = ~IndexGeneration;
+	WriteIndex(&Header.Commit, INDEX_ADDRESS + offsetof(IndexHeader_t, Commit), sizeof(Header.Commit));
+
+	JournalCount = 0;
+	JournalFreqEnd = 0;
+}
+
+// Fails on anything unexpected, including a save that was interrupted before it completed.
+static bool LoadIndex(void)
+{
+	IndexHeader_t Header;
+	IndexEntry_t Entry;
+
+	SFLASH_Read(&Header, INDEX_ADDRESS, sizeof(Header));
+	if (Header.Magic != INDEX_MAGIC) {
+		return false;
+	}
+	IndexGeneration = Header.Generation;
+	if (Header.Commit != ~Header.Generation || Header.bFLock != gSettings.bFLock) {
+		return false;
+	}
+
+	SFLASH_Read(ChannelIndex, INDEX_BITMAP, sizeof(ChannelIndex));
+	SFLASH_Read(ChannelMasks, INDEX_MASKS, sizeof(ChannelMasks));
+	JournalFreqEnd = 0;
+	for (JournalCount = 0; JournalCount < INDEX_JOURNAL_SIZE; JournalCount++) {
+		SFLASH_Read(&Entry, INDEX_JOURNAL + (JournalCount * sizeof(Entry)), sizeof(Entry));
+		if (Entry.Channel == 0xFFFF) {
+			break;
+		}
+		if (Entry.Channel >= CHANNEL_COUNT || (Entry.Flags & INDEX_PENDING) || (Entry.Flags & ~(INDEX_USED | INDEX_FREQ_SAME | INDEX_PENDING)) != INDEX_GENERATION(IndexGeneration)) {
+			return false;
+		}
+		if (!(Entry.Flags & INDEX_FREQ_SAME)) {
+			JournalFreqEnd = JournalCount + 1;
+		}
+		SetIndexBit(ChannelIndex, Entry.Channel, Entry.Flags & INDEX_USED);
+		ChannelMasks[Entry.Channel] = Entry.IsInscanList;
+	}
+
+	return true;
+}
+
+static uint32_t GetFreqBankAddress(uint8_t Bank)
+{
+	return FREQ_INDEX_ADDRESS + (Bank * FREQ_INDEX_BANK_SIZE);
+}
+
+static uint32_t GetFreqEntryAddress(uint8_t Bank, uint16_t Index)
+{
+	return GetFreqBankAddress(Bank) + sizeof(FreqIndexHeader_t) + (Index * sizeof(FreqIndexEntry_t));
+}
+
+static bool IsFreqEntryBefore(const FreqIndexEntry_t *pA, const FreqIndexEntry_t *pB)
+{
+	if (pA->Frequency != pB->Frequency) {
+		return pA->Frequency < pB->Frequency;
+	}
+
+	return pA->Channel < pB->Channel;
+}
+
+// Erases the bank not in use and returns it.
+static uint8_t StartFreqBank(void)
+{
+	const uint8_t Bank = (FreqBank == 0) ? 1 : 0;
+	uint8_t i;
+
+	HARDWARE_EnableInterrupts(false);
+	for (i = 0; i < FREQ_INDEX_BANK_SIZE / 0x1000U; i++) {
+		SFLASH_Erase((GetFreqBankAddress(Bank) >> 12) + i);
+	}
+	HARDWARE_EnableInterrupts(true);
+
+	return Bank;
+}
+
+static void CommitFreqBank(uint8_t Bank, uint16_t Count)
+{
+	const uint32_t Address = GetFreqBankAddress(Bank);
+	FreqIndexHeader_t Header;
+
+	memset(&Header, 0xFF, sizeof(Header));
+	Header.Magic = FREQ_INDEX_MAGIC;
+	Header.Sequence = FreqSequence + 1;
+	Header.Generation = IndexGeneration;
+	Header.Journal = JournalCount;
+	Header.Count = Count;
+	WriteIndex(&Header, Address, sizeof(Header));
+	Header.Commit = ~Header.Sequence;
+	WriteIndex(&Header.Commit, Address + offsetof(FreqIndexHeader_t, Commit), sizeof(Header.Commit));
+
+	FreqBank = Bank;
+	FreqSequence = Header.Sequence;
+	FreqCount = Count;
+}
+
+// Picks the newest committed bank, it is only usable when it matches the channel index.
+static bool LoadFreqIndex(void)
+{
+	FreqIndexHeader_t Header;
+	uint32_t Generation = 0;
+	uint16_t Journal = 0;
+	uint8_t Bank;
+
+	FreqBank = FREQ_INDEX_NONE;
+	for (Bank = 0; Bank < 2; Bank++) {
+		SFLASH_Read(&Header, GetFreqBankAddress(Bank), sizeof(Header));
+		if (Header.Magic == FREQ_INDEX_MAGIC && Header.Commit == ~Header.Sequence && Header.Count <= CHANNEL_COUNT && (FreqBank == FREQ_INDEX_NONE || Header.Sequence > FreqSequence)) {
+			FreqBank = Bank;
+			FreqSequence = Header.Sequence;
+			FreqCount = Header.Count;
+			Generation = Header.Generation;
+			Journal = Header.Journal;
+		}
+	}
+
+	return FreqBank != FREQ_INDEX_NONE && Generation == IndexGeneration && Journal >= JournalFreqEnd && Journal <= JournalCount;
+}
+
+// Sorts in gFlashBuffer, so this only runs at boot.
+static void RebuildFreqIndex(void)
+{
+	FreqIndexEntry_t *pEntries = (FreqIndexEntry_t *)gFlashBuffer;
+	FreqIndexEntry_t Entry;
+	uint16_t Count = 0;
+	uint16_t i, j;
+	uint8_t Bank;
+
+	for (i = 0; i < CHANNEL_COUNT; i++) {
+		if (!GetIndexBit(ChannelIndex, i)) {
+			continue;
+		}
+		SFLASH_Read(&Entry.Frequency, 0x3C2000 + (i * sizeof(ChannelInfo_t)), sizeof(Entry.Frequency));
+		Entry.Channel = i;
+		Entry.Reserved = 0xFFFF;
+		// Channels are mostly programmed in frequency order, which keeps the insertion short
+		for (j = Count; j > 0 && IsFreqEntryBefore(&Entry, &pEntries[j - 1]); j--) {
+			pEntries[j] = pEntries[j - 1];
+		}
+		pEntries[j] = Entry;
+		Count++;
+	}
+
+	Bank = StartFreqBank();
+	if (Count) {
+		WriteIndex(pEntries, GetFreqEntryAddress(Bank, 0), Count * sizeof(Entry));
+	}
+	CommitFreqBank(Bank, Count);
+}
+
+// Merges the current bank and the saved channel into the other bank, a chunk at a time.
+static void UpdateFreqIndex(uint16_t Channel, const ChannelInfo_t *pChannel)
+{
+	const uint8_t From = FreqBank;
+	FreqIndexEntry_t In[FREQ_INDEX_CHUNK];
+	FreqIndexEntry_t Out[FREQ_INDEX_CHUNK];
+	FreqIndexEntry_t Entry;
+	bool bInsert = !IsChannelEmpty(pChannel);
+	uint16_t Read = 0;
+	uint16_t Written = 0;
+	uint8_t InCount = 0;
+	uint8_t InPos = 0;
+	uint8_t OutCount = 0;
+	uint8_t To;
+
+	if (From == FREQ_INDEX_NONE) {
+		return;
+	}
+
+	Entry.Frequency = pChannel->RX.Frequency;
+	Entry.Channel = Channel;
+	Entry.Reserved = 0xFFFF;
+	To = StartFreqBank();
+
+	while (1) {
+		if (InPos == InCount && Read < FreqCount) {
+			InCount = (FreqCount - Read < FREQ_INDEX_CHUNK) ? FreqCount - Read : FREQ_INDEX_CHUNK;
+			SFLASH_Read(In, GetFreqEntryAddress(From, Read), InCount * sizeof(Entry));
+			Read += InCount;
+			InPos = 0;
+		}
+		if (InPos == InCount && !bInsert) {
+			break;
+		}
+		if (InPos < InCount && In[InPos].Channel == Channel) {
+			InPos++;
+			continue;
+		}
+		if (bInsert && (InPos == InCount || IsFreqEntryBefore(&Entry, &In[InPos]))) {
+			Out[OutCount++] = Entry;
+			bInsert = false;
+		} else {
+			Out[OutCount++] = In[InPos++];
+		}
+		if (OutCount == FREQ_INDEX_CHUNK) {
+			WriteIndex(Out, GetFreqEntryAddress(To, Written), sizeof(Out));
+			Written += OutCount;
+			OutCount = 0;
+		}
+	}
+	if (OutCount) {
+		WriteIndex(Out, GetFreqEntryAddress(To, Written), OutCount * sizeof(Entry));
+		Written += OutCount;
+	}
+
+	CommitFreqBank(To, Written);
+}
+
+// Returns true when the index had to be rebuilt from the channels.
+bool CHANNELS_BuildIndex(void)
+{
+	bool bRebuilt = false;
+
+	ListIndexLists = 0;
+	if (!LoadIndex()) {
+		RebuildIndex();
+		bRebuilt = true;
+	}
+	if (!LoadFreqIndex()) {
+		RebuildFreqIndex();
+		bRebuilt = true;
+	}
+
+	return bRebuilt;
+}
+
+void CHANNELS_InvalidateIndex(void)
+{
+	CacheUsed = 0;
+	HARDWARE_EnableInterrupts(false);
+	SFLASH_Erase(INDEX_ADDRESS >> 12);
+	SFLASH_Erase(GetFreqBankAddress(0) >> 12);
+	SFLASH_Erase(GetFreqBankAddress(1) >> 12);
+	HARDWARE_EnableInterrupts(true);
+	FreqBank = FREQ_INDEX_NONE;
+}
+
+// Returns the channel with the RX frequency closest to Frequency, preferring the lowest channel
+// number among equals, or 0xFFFF when there is none.
+uint16_t CHANNELS_FindByFrequency(uint32_t Frequency)
+{
+	FreqIndexEntry_t Above;
+	FreqIndexEntry_t Below;
+	uint16_t Low = 0;
+	uint16_t High = FreqCount;
+	uint16_t Middle;
+
+	if (FreqBank == FREQ_INDEX_NONE || FreqCount == 0) {
+		return CHANNEL_NONE;
+	}
+
+	// Finds the first entry at or above Frequency
+	while (Low < High) {
+		Middle = (Low + High) / 2;
+		SFLASH_Read(&Above, GetFreqEntryAddress(FreqBank, Middle), sizeof(Above));
+		if (Above.Frequency < Frequency) {
+			Low = Middle + 1;
+		} else {
+			High = Middle;
+		}
+	}
+
+	if (Low > 0) {
+		SFLASH_Read(&Below, GetFreqEntryAddress(FreqBank, Low - 1), sizeof(Below));
+		if (Low == FreqCount) {
+			return Below.Channel;
+		}
+	}
+	SFLASH_Read(&Above, GetFreqEntryAddress(FreqBank, Low), sizeof(Above));
+	if (Low == 0 || Above.Frequency - Frequency <= Frequency - Below.Frequency) {
+		return Above.Channel;
+	}
+
+	return Below.Channel;
+}
+
+// Merging only counts with at least one list selected, erased settings leave it off.
+bool CHANNELS_IsScanMerged(void)
+{
+	return gExtendedSettings.ScanMerged && gExtendedSettings.ScanListSkip != 0xFF;
+}
+
+// Returns the lists a memory scan covers, 1 bit per list.
+uint8_t CHANNELS_GetScanLists(void)
+{
+	if (CHANNELS_IsScanMerged()) {
+		return (uint8_t)~gExtendedSettings.ScanListSkip;
+	}
+
+	return 1U << gExtendedSettings.CurrentScanList;
+}
+
+bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist) {
+	const uint16_t startChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
+	const uint32_t *pIndex = OnlyFromScanlist ? GetListIndex() : ChannelIndex;
+	uint16_t Channel;
+
+	if (gScannerMode && !gExtendedSettings.ScanActiveFirstOff) {
+		Channel = FindActiveFirst(pIndex, Key == KEY_UP);
+	} else {
+		Channel = FindChannel(pIndex, startChannel, Key == KEY_UP);
+	}
+	if (Channel == CHANNEL_NONE || Channel == startChannel) {
+		return false;	// empty list
+	}
+	gSettings.VfoChNo[gSettings.CurrentVfo] = Channel;
+	CHANNELS_LoadChannel(Channel, gSettings.CurrentVfo);
+	ResetPrefetch();
+	if (gScannerMode) {
+		RADIO_ScanTune(gSettings.CurrentVfo);
+	} else {
+		RADIO_Tune(gSettings.CurrentVfo);
+	}
 	UI_DrawVfo(gSettings.CurrentVfo);
 	return true;
 }
@@ -451,6 +1162,89 @@ void CHANNELS_NextChannelVfo(uint8_t Key)
 	UI_DrawVfo(gSettings.CurrentVfo);
 }
 
+// Unprogrammed limits read as 0xFFFFFFFF and leave the band scan off.
+bool CHANNELS_IsBandScan(void)
+{
+	return !gSettings.WorkMode
+		&& gExtendedSettings.BandScan
+		&& gExtendedSettings.BandScanLower < gExtendedSettings.BandScanUpper
+		&& gExtendedSettings.BandScanUpper <= 130000000;
+}
+
+// Steps the current VFO between the band scan limits, wrapping at the edges. Nothing is drawn,
+// the scanner redraws the VFO when it stops.
+void CHANNELS_NextBandScan(uint8_t Key)
+{
+	ChannelInfo_t *pInfo = &gVfoState[gSettings.CurrentVfo];
+	const uint32_t Lower = gExtendedSettings.BandScanLower;
+	const uint32_t Upper = gExtendedSettings.BandScanUpper;
+	const uint32_t Step = FREQUENCY_GetStep(gExtendedSettings.BandScanStep);
+	uint32_t Frequency = pInfo->RX.Frequency;
+
+	if (Frequency < Lower || Frequency > Upper) {
+		Frequency = (Key == KEY_UP) ? Lower : Upper;
+	} else if (Key == KEY_UP) {
+		Frequency = (Upper - Frequency < Step) ? Lower : Frequency + Step;
+	} else {
+		Frequency = (Frequency - Lower < Step) ? Upper : Frequency - Step;
+	}
+
+	pInfo->RX.Frequency = Frequency;
+	pInfo->TX.Frequency = Frequency;
+	gVfoInfo[gSettings.CurrentVfo].Frequency = Frequency;
+}
+
+// Runs one step of the prefetch for the hop CHANNELS_NextChannelMr() would take next.
+void CHANNELS_Prefetch(uint8_t Key, bool OnlyFromScanlist)
+{
+	const uint32_t *pIndex;
+	uint8_t Position;
+
+	switch (PrefetchStage) {
+	case PREFETCH_IDLE:
+		pIndex = OnlyFromScanlist ? GetListIndex() : ChannelIndex;
+		if (!gExtendedSettings.ScanActiveFirstOff) {
+			PrefetchChannel = PeekActiveFirst(pIndex, Key == KEY_UP);
+		} else {
+			PrefetchChannel = FindChannel(pIndex, gSettings.VfoChNo[gSettings.CurrentVfo], Key == KEY_UP);
+		}
+		PrefetchOffset = 0;
+		Position = FindCacheEntry(PrefetchChannel);
+		if (PrefetchChannel == CHANNEL_NONE) {
+			PrefetchStage = PREFETCH_READY;
+		} else if (Position < CHANNEL_CACHE_SIZE) {
+			PrefetchData = CacheData[CacheOrder[Position]];
+			PrefetchStage = PREFETCH_DECODE;
+		} else {
+			PrefetchStage = PREFETCH_READ;
+		}
+		break;
+
+	case PREFETCH_READ:
+		SFLASH_Read((uint8_t *)&PrefetchData + PrefetchOffset, 0x3C2000 + (PrefetchChannel * sizeof(ChannelInfo_t)) + PrefetchOffset, PREFETCH_CHUNK);
+		PrefetchOffset += PREFETCH_CHUNK;
+		if (PrefetchOffset >= sizeof(PrefetchData)) {
+			*AddCacheEntry(PrefetchChannel) = PrefetchData;
+			PrefetchStage = PREFETCH_DECODE;
+		}
+		break;
+
+	case PREFETCH_DECODE:
+		RADIO_StageScanTune(PrefetchChannel, &PrefetchData);
+		PrefetchStage = PREFETCH_READY;
+		break;
+
+	default:
+		break;
+	}
+}
+
+// Returns the channel the prefetch has completed for, or 0xFFFF.
+uint16_t CHANNELS_GetPrefetched(void)
+{
+	return PrefetchStage == PREFETCH_READY ? PrefetchChannel : CHANNEL_NONE;
+}
+
 #ifdef ENABLE_NOAA
 void CHANNELS_NextNOAA(uint8_t Key)
 {
@@ -551,39 +1345,22 @@ void CHANNELS_UpdateVFO(void)
 
 bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
 {
-	uint32_t Frequency;
+	return CHANNELS_ReadChannel(ChNo, &gVfoState[Vfo]);
+}
 
-	SFLASH_Read(&gVfoState[Vfo], 0x3C2000 + (ChNo * sizeof(ChannelInfo_t)), sizeof(ChannelInfo_t));
-	if (gSettings.bFLock) {
-		Frequency = gVfoState[Vfo].RX.Frequency;
-		if (Frequency > 44000000) {
-			return true;
-		}
-		if (Frequency > 14600000 && Frequency < 43000000) {
-			return true;
-		}
-		if (Frequency > 13600000 && Frequency < 14400000) {
-			return true;
-		}
-		if (Frequency < 10800000) {
-			return true;
-		}
-		Frequency = gVfoState[Vfo].TX.Frequency;
-		if (Frequency > 44000000) {
-			return true;
-		}
-		if (Frequency > 14600000 && Frequency < 43000000) {
-			return true;
-		}
-		if (Frequency > 13600000 && Frequency < 14400000) {
-			return true;
-		}
-		if (Frequency < 10800000) {
-			return true;
-		}
-	}
+bool CHANNELS_ReadChannel(uint16_t ChNo, ChannelInfo_t *pChannel)
+{
+	*pChannel = *GetCachedChannel(ChNo);
+
+	return IsChannelEmpty(pChannel);
+}
+
+uint8_t CHANNELS_GetCacheStats(uint32_t *pHits, uint32_t *pMisses)
+{
+	*pHits = CacheHits;
+	*pMisses = CacheMisses;
 
-	return gVfoState[Vfo].Available;
+	return CHANNEL_CACHE_SIZE;
 }
 
 void CHANNELS_CheckFreeChannels(void)
@@ -591,8 +1368,8 @@ void CHANNELS_CheckFreeChannels(void)
 	uint16_t i;
 
 	gFreeChannelsCount = 0;
-	for (i = 0; i < 999; i++) {
-		if (!CHANNELS_LoadChannel(i, 0)) {
+	for (i = 0; i < CHANNEL_COUNT; i++) {
+		if (GetIndexBit(ChannelIndex, i)) {
 			gFreeChannelsCount++;
 		}
 	}
@@ -610,11 +1387,11 @@ void CHANNELS_LoadVfoMode(void)
 	memcpy(&VfoState[0], &VfoTemplate, sizeof(VfoState));
 
 	while (CHANNELS_LoadChannel(999, 0)) {
-		SFLASH_Update(&VfoState[0], 0x3C9CE0, sizeof(VfoState[0]));
+		CHANNELS_SaveChannel(999, &VfoState[0]);
 	}
 
 	while (CHANNELS_LoadChannel(1000, 1)) {
-		SFLASH_Update(&VfoState[1], 0x3C9D00, sizeof(VfoState[1]));
+		CHANNELS_SaveChannel(1000, &VfoState[1]);
 	}
 
 	if (gSettings.CurrentVfo) {
@@ -643,37 +1420,73 @@ void CHANNELS_LoadWorkMode(void)
 	}
 }
 
+// Both load the channel found into gVfoState[Vfo]. The channel is kept when no channel is in use.
 uint16_t CHANNELS_GetChannelUp(uint16_t Channel, uint8_t Vfo)
 {
-	Channel++;
-	while (1) {
-		Channel %= 999;
-		if (!CHANNELS_LoadChannel(Channel, Vfo)) {
-			break;
-		}
-		Channel++;
+	const uint16_t Next = FindChannel(ChannelIndex, Channel, true);
+
+	if (Next != CHANNEL_NONE) {
+		Channel = Next;
 	}
+	CHANNELS_LoadChannel(Channel, Vfo);
 
 	return Channel;
 }
 
 uint16_t CHANNELS_GetChannelDown(uint16_t Channel, uint8_t Vfo)
 {
-	Channel += 998;
-	while (1) {
-		Channel %= 999;
-		if (!CHANNELS_LoadChannel(Channel, Vfo)) {
-			break;
-		}
-		Channel += 998;
+	const uint16_t Next = FindChannel(ChannelIndex, Channel, false);
+
+	if (Next != CHANNEL_NONE) {
+		Channel = Next;
 	}
+	CHANNELS_LoadChannel(Channel, Vfo);
 
 	return Channel;
 }
 
 void CHANNELS_SaveChannel(uint16_t Channel, const ChannelInfo_t *pChannel)
 {
-	SFLASH_Update(pChannel, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(*pChannel));
+	const uint32_t Address = INDEX_JOURNAL + (JournalCount * sizeof(IndexEntry_t));
+	const bool bUsed = !IsChannelEmpty(pChannel);
+	IndexEntry_t Entry;
+	uint32_t Frequency;
+	bool bFreqSame;
+
+	UpdateCachedChannel(Channel, pChannel);
+	RADIO_ClearScanTunes();
+	ResetPrefetch();
+
+	if (Channel >= CHANNEL_COUNT) {
+		SFLASH_Update(pChannel, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(*pChannel));
+		return;
+	}
+
+	// Name, CSS, power and the like do not move the channel in the frequency index
+	SFLASH_Read(&Frequency, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(Frequency));
+	bFreqSame = GetIndexBit(ChannelIndex, Channel) == bUsed && (!bUsed || Frequency == pChannel->RX.Frequency);
+
+	if (JournalCount >= INDEX_JOURNAL_SIZE) {
+		SFLASH_Update(pChannel, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(*pChannel));
+		RebuildIndex();
+		// The bank has to be committed with the new generation
+		bFreqSame = false;
+	} else {
+		// The entry is marked pending until the channel is written, so an interrupted save
+		// forces a rebuild at the next boot.
+		Entry.Channel = Channel;
+		Entry.IsInscanList = pChannel->IsInscanList;
+		Entry.Flags = INDEX_PENDING | INDEX_GENERATION(IndexGeneration) | (bFreqSame ? INDEX_FREQ_SAME : 0) | (bUsed ? INDEX_USED : 0);
+		WriteIndex(&Entry, Address, sizeof(Entry));
+		SFLASH_Update(pChannel, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(*pChannel));
+		Entry.Flags &= ~INDEX_PENDING;
+		WriteIndex(&Entry.Flags, Address + offsetof(IndexEntry_t, Flags), sizeof(Entry.Flags));
+		JournalCount++;
+	}
+	UpdateIndex(Channel, pChannel);
+	if (!bFreqSame) {
+		UpdateFreqIndex(Channel, pChannel);
+	}
 }
 
 #ifdef ENABLE_NOAA
@@ -55,6 +55,10 @@ extern uint16_t gFreeChannelsCount;
 
 bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist);
 void CHANNELS_NextChannelVfo(uint8_t Key);
+void CHANNELS_Prefetch(uint8_t Key, bool OnlyFromScanlist);
+uint16_t CHANNELS_GetPrefetched(void);
+bool CHANNELS_IsBandScan(void);
+void CHANNELS_NextBandScan(uint8_t Key);
 #ifdef ENABLE_NOAA
 void CHANNELS_NextNOAA(uint8_t Key);
 #endif
@@ -64,6 +68,13 @@ void CHANNELS_UpdateChannel(void);
 void CHANNELS_UpdateVFO(void);
 
 bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo);
+bool CHANNELS_ReadChannel(uint16_t ChNo, ChannelInfo_t *pChannel);
+uint8_t CHANNELS_GetCacheStats(uint32_t *pHits, uint32_t *pMisses);
+bool CHANNELS_BuildIndex(void);
+void CHANNELS_InvalidateIndex(void);
+uint16_t CHANNELS_FindByFrequency(uint32_t Frequency);
+bool CHANNELS_IsScanMerged(void);
+uint8_t CHANNELS_GetScanLists(void);
 void CHANNELS_CheckFreeChannels(void);
 void CHANNELS_LoadVfoMode(void);
 void CHANNELS_LoadWorkMode(void);
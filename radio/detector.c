@@ -49,17 +49,42 @@ static uint32_t RoundToNearest50(uint32_t Frequency)
 	return Value;
 }
 
+// Polls the frequency scanner started by BK4819_StartFrequencyScan(), returns false until it has locked.
+bool DETECTOR_GetScanFrequency(bool bUseVHF, uint32_t *pFrequency)
+{
+	uint32_t Frequency;
+	uint16_t Result;
+
+	Result = BK4819_ReadRegister(0x0D);
+	if (Result & 0x8000U) {
+		return false;
+	}
+
+	Frequency = (Result & 0x07FF) << 16;
+	Frequency |= BK4819_ReadRegister(0x0E);
+
+	if (!bUseVHF || Frequency <= 24000000) {
+		if (!bUseVHF && Frequency < 24000000) {
+			Frequency *= 2U;
+		}
+	} else {
+		Frequency /= 2U;
+	}
+	FREQUENCY_SelectBand(Frequency);
+	*pFrequency = RoundToNearest50(32808U + (Frequency - gFrequencyBandInfo.FrequencyOffset));
+
+	return true;
+}
+
 static bool CheckScanResult(void)
 {
 	uint32_t Frequency;
 	uint16_t Timeout;
-	uint16_t Result;
 
 	Timeout = 1000;
 	while (Timeout) {
 		DELAY_WaitMS(1);
-		Result = BK4819_ReadRegister(0x0D);
-		if ((Result & 0x8000U) == 0) {
+		if (DETECTOR_GetScanFrequency(gSettings.bUseVHF, &Frequency)) {
 			break;
 		}
 		Timeout--;
@@ -69,18 +94,6 @@ static bool CheckScanResult(void)
 		return false;
 	}
 
-	Frequency = (Result & 0x07FF) << 16;
-	Frequency |= BK4819_ReadRegister(0x0E);
-
-	if (!gSettings.bUseVHF || Frequency <= 24000000) {
-		if (!gSettings.bUseVHF && Frequency < 24000000) {
-			Frequency *= 2U;
-		}
-	} else {
-		Frequency /= 2U;
-	}
-	FREQUENCY_SelectBand(Frequency);
-	Frequency = RoundToNearest50(32808U + (Frequency - gFrequencyBandInfo.FrequencyOffset));
 	gVfoState[gSettings.CurrentVfo].RX.Frequency = Frequency;
 	gVfoState[gSettings.CurrentVfo].TX.Frequency = Frequency;
 	UI_DrawScanFrequency(Frequency);
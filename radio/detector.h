@@ -17,6 +17,10 @@
 #ifndef RADIO_DETECTOR_H
 #define RADIO_DETECTOR_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
+bool DETECTOR_GetScanFrequency(bool bUseVHF, uint32_t *pFrequency);
 void RADIO_FrequencyDetect(void);
 
 #endif
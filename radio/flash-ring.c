@@ -0,0 +1,77 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "driver/serial-flash.h"
+#include "radio/flash-ring.h"
+#include "radio/hardware.h"
+
+// Slots are only ever programmed. A sector is erased when the ring moves into it, or when the
+// slot being started is not blank, so the older slots survive an interrupted erase.
+
+uint32_t FLASHRING_GetAddress(const FlashRing_t *pRing, uint8_t Slot)
+{
+	return pRing->Address + (Slot * pRing->SlotSize);
+}
+
+// Returns the newest slot and its sequence, or pRing->Slots when no slot has the magic.
+uint8_t FLASHRING_FindLatest(const FlashRing_t *pRing, uint32_t *pSequence)
+{
+	uint32_t Header[2];
+	uint8_t Latest = pRing->Slots;
+	uint8_t i;
+
+	*pSequence = 0;
+	for (i = 0; i < pRing->Slots; i++) {
+		SFLASH_Read(Header, FLASHRING_GetAddress(pRing, i), sizeof(Header));
+		if (Header[0] == pRing->Magic && (Latest == pRing->Slots || Header[1] > *pSequence)) {
+			*pSequence = Header[1];
+			Latest = i;
+		}
+	}
+
+	return Latest;
+}
+
+// Programs part of a slot, a write at Offset 0 starts the slot.
+void FLASHRING_Write(const FlashRing_t *pRing, uint8_t Slot, uint16_t Offset, const void *pBuffer, uint16_t Size)
+{
+	const uint32_t Address = FLASHRING_GetAddress(pRing, Slot);
+	uint32_t Magic = 0xFFFFFFFFU;
+
+	if (Offset == 0) {
+		SFLASH_Read(&Magic, Address, sizeof(Magic));
+	}
+
+	HARDWARE_EnableInterrupts(false);
+	if (Offset == 0 && ((Address & 0xFFFU) == 0 || Magic != 0xFFFFFFFFU)) {
+		SFLASH_Erase(Address >> 12);
+	}
+	SFLASH_Write(pBuffer, Address + Offset, Size);
+	HARDWARE_EnableInterrupts(true);
+}
+
+void FLASHRING_Clear(const FlashRing_t *pRing)
+{
+	const uint8_t Sectors = (pRing->Slots * pRing->SlotSize) / 0x1000U;
+	uint8_t i;
+
+	HARDWARE_EnableInterrupts(false);
+	for (i = 0; i < Sectors; i++) {
+		SFLASH_Erase((pRing->Address >> 12) + i);
+	}
+	HARDWARE_EnableInterrupts(true);
+}
+
@@ -0,0 +1,37 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_FLASH_RING_H
+#define RADIO_FLASH_RING_H
+
+#include <stdint.h>
+
+// A ring of equal sized slots over whole sectors of the SPI flash. Every slot starts with a
+// magic and a sequence number, the slot with the highest sequence is the newest.
+typedef struct {
+	uint32_t Address;	// sector aligned
+	uint32_t Magic;
+	uint16_t SlotSize;	// divides the sector size
+	uint8_t Slots;
+} FlashRing_t;
+
+uint32_t FLASHRING_GetAddress(const FlashRing_t *pRing, uint8_t Slot);
+uint8_t FLASHRING_FindLatest(const FlashRing_t *pRing, uint32_t *pSequence);
+void FLASHRING_Write(const FlashRing_t *pRing, uint8_t Slot, uint16_t Offset, const void *pBuffer, uint16_t Size);
+void FLASHRING_Clear(const FlashRing_t *pRing);
+
+#endif
+
@@ -0,0 +1,157 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "driver/serial-flash.h"
+#include "radio/lockout.h"
+#include "radio/settings.h"
+#include "radio/stats.h"
+
+// Scanner lockouts, sorted by expiry so expired entries always leave from the front. A bit per
+// (Key % 32) in LockoutMask lets most hops skip the table walk.
+#define LOCKOUT_ADDRESS		0x3D5100U
+#define LOCKOUT_MAGIC		0x31544F4CU // "LOT1"
+
+typedef struct {
+	uint32_t Magic;
+	uint32_t Clock;		// when it was saved
+	uint8_t Count;
+	uint8_t Reserved[3];
+	Lockout_t Entries[LOCKOUT_COUNT];
+} LockoutTable_t;
+
+static LockoutTable_t Table;
+static uint32_t LockoutMask;
+
+static void UpdateMask(void)
+{
+	uint8_t i;
+
+	LockoutMask = 0;
+	for (i = 0; i < Table.Count; i++) {
+		LockoutMask |= 1U << (Table.Entries[i].Key % 32U);
+	}
+}
+
+void LOCKOUT_Save(void)
+{
+	if (!gExtendedSettings.LockoutKeepOff) {
+		Table.Clock = STATS_GetClock();
+		SFLASH_Update(&Table, LOCKOUT_ADDRESS, sizeof(Table));
+	}
+}
+
+static void Remove(uint8_t Index)
+{
+	Table.Count--;
+	memmove(&Table.Entries[Index], &Table.Entries[Index + 1], (Table.Count - Index) * sizeof(Lockout_t));
+}
+
+// Expired entries are not saved right away, the next save or boot drops them.
+static void Expire(void)
+{
+	const uint32_t Now = STATS_GetClock();
+	bool bExpired = false;
+
+	while (Table.Count && Table.Entries[0].Expiry <= Now) {
+		Remove(0);
+		bExpired = true;
+	}
+	if (bExpired) {
+		UpdateMask();
+	}
+}
+
+// Saved expiries are moved to the current clock, the statistics clock is only saved while
+// receiving and can be behind the one the table was saved with.
+void LOCKOUT_Init(void)
+{
+	const uint32_t Now = STATS_GetClock();
+	uint8_t i;
+
+	Table.Magic = LOCKOUT_MAGIC;
+	Table.Count = 0;
+	if (!gExtendedSettings.LockoutKeepOff) {
+		LockoutTable_t Saved;
+
+		SFLASH_Read(&Saved, LOCKOUT_ADDRESS, sizeof(Saved));
+		if (Saved.Magic == LOCKOUT_MAGIC && Saved.Count <= LOCKOUT_COUNT) {
+			Table = Saved;
+			for (i = 0; i < Table.Count; i++) {
+				if (Table.Entries[i].Expiry != LOCKOUT_FOREVER) {
+					Table.Entries[i].Expiry = Now + (Table.Entries[i].Expiry > Table.Clock ? Table.Entries[i].Expiry - Table.Clock : 0);
+				}
+			}
+		}
+	}
+	Expire();
+	UpdateMask();
+}
+
+void LOCKOUT_Add(uint32_t Key, uint32_t Duration)
+{
+	const uint32_t Now = STATS_GetClock();
+	Lockout_t Entry;
+	uint8_t i;
+
+	Entry.Key = Key;
+	Entry.Expiry = Duration == LOCKOUT_FOREVER || Now + Duration < Now ? LOCKOUT_FOREVER : Now + Duration;
+
+	for (i = 0; i < Table.Count; i++) {
+		if (Table.Entries[i].Key == Key) {
+			Remove(i);
+			break;
+		}
+	}
+	if (Table.Count == LOCKOUT_COUNT) {
+		Remove(0);	// the one that would expire first
+	}
+	for (i = Table.Count; i > 0 && Table.Entries[i - 1].Expiry > Entry.Expiry; i--) {
+		Table.Entries[i] = Table.Entries[i - 1];
+	}
+	Table.Entries[i] = Entry;
+	Table.Count++;
+	UpdateMask();
+	LOCKOUT_Save();
+}
+
+bool LOCKOUT_Check(uint32_t Key)
+{
+	uint8_t i;
+
+	if (!Table.Count) {
+		return false;
+	}
+	Expire();
+	if (!(LockoutMask & (1U << (Key % 32U)))) {
+		return false;
+	}
+	for (i = 0; i < Table.Count; i++) {
+		if (Table.Entries[i].Key == Key) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void LOCKOUT_Clear(void)
+{
+	Table.Count = 0;
+	LockoutMask = 0;
+	SFLASH_Update(&Table, LOCKOUT_ADDRESS, sizeof(Table));
+}
+
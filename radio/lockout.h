@@ -0,0 +1,40 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_LOCKOUT_H
+#define RADIO_LOCKOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LOCKOUT_COUNT		8
+#define LOCKOUT_FOREVER		0xFFFFFFFFU
+
+// Key is a memory channel number or, in VFO mode, a frequency. Frequencies are in 10 Hz units,
+// so the two never collide.
+typedef struct {
+	uint32_t Key;
+	uint32_t Expiry;	// STATS_GetClock() seconds
+} Lockout_t;
+
+void LOCKOUT_Init(void);
+void LOCKOUT_Add(uint32_t Key, uint32_t Duration);
+bool LOCKOUT_Check(uint32_t Key);
+void LOCKOUT_Save(void);
+void LOCKOUT_Clear(void);
+
+#endif
+
@@ -0,0 +1,168 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "driver/serial-flash.h"
+#include "radio/flash-ring.h"
+#include "radio/hardware.h"
+#include "radio/scanlog.h"
+#include "radio/scheduler.h"
+#include "radio/stats.h"
+
+// Scanner stops are collected in a RAM image of the current page. A full page, or the partial
+// one when scanning is turned off, is programmed over its erased part, so the flash sees page
+// programs only. Sectors are erased as the log wraps into them. The page image is also read by
+// the UART interrupt, it only changes with interrupts disabled.
+#define SCANLOG_ADDRESS		0x3EC000U
+#define SCANLOG_MAGIC		0x31474C53U // "SLG1"
+
+static const FlashRing_t Ring = { SCANLOG_ADDRESS, SCANLOG_MAGIC, sizeof(ScanLogPage_t), SCANLOG_PAGES };
+
+static ScanLogPage_t Page;
+static ScanLogRecord_t Record;
+static uint32_t RxStart;
+static uint32_t RxLast;
+static uint16_t RssiPeak;
+static uint8_t CurrentPage;
+static uint8_t Count;
+static uint8_t Programmed;
+static bool bOpen;
+
+static void StartPage(uint8_t Index, uint32_t Sequence)
+{
+	HARDWARE_EnableInterrupts(false);
+	memset(&Page, 0xFF, sizeof(Page));
+	Page.Magic = SCANLOG_MAGIC;
+	Page.Sequence = Sequence;
+	CurrentPage = Index;
+	Count = 0;
+	Programmed = 0;
+	HARDWARE_EnableInterrupts(true);
+}
+
+void SCANLOG_Init(void)
+{
+	uint32_t Sequence;
+	const uint8_t Latest = FLASHRING_FindLatest(&Ring, &Sequence);
+	uint8_t i;
+
+	if (Latest == SCANLOG_PAGES) {
+		StartPage(0, 0);
+		return;
+	}
+
+	// The newest page keeps filling up where it was left.
+	SFLASH_Read(&Page, FLASHRING_GetAddress(&Ring, Latest), sizeof(Page));
+	for (i = 0; i < SCANLOG_RECORDS && Page.Records[i].Time != 0xFFFFFFFFU; i++) {
+	}
+	if (i == SCANLOG_RECORDS) {
+		StartPage((Latest + 1) % SCANLOG_PAGES, Sequence + 1);
+	} else {
+		CurrentPage = Latest;
+		Count = i;
+		Programmed = i;
+	}
+}
+
+void SCANLOG_Start(uint16_t Channel, const FrequencyInfo_t *pInfo)
+{
+	Record.Time = STATS_GetClock();
+	Record.Frequency = pInfo->Frequency;
+	Record.Channel = Channel;
+	Record.Code = pInfo->Code;
+	Record.CodeType = pInfo->CodeType;
+	RxStart = gTimeSinceBoot;
+	RxLast = RxStart;
+	RssiPeak = 0;
+	bOpen = true;
+}
+
+// Called while the squelch is open
+void SCANLOG_UpdateRX(uint16_t Rssi)
+{
+	if (RssiPeak < Rssi) {
+		RssiPeak = Rssi;
+	}
+	RxLast = gTimeSinceBoot;
+}
+
+void SCANLOG_End(uint8_t Reason)
+{
+	uint32_t Duration;
+
+	if (!bOpen) {
+		return;
+	}
+	bOpen = false;
+
+	Duration = (RxLast - RxStart + 50U) / 100U;
+	Record.Duration = Duration > 0xFFFFU ? 0xFFFFU : Duration;
+	Record.Rssi = RssiPeak > 0x1FFU ? 0xFF : RssiPeak >> 1;
+	Record.Reason = Reason;
+	HARDWARE_EnableInterrupts(false);
+	Page.Records[Count++] = Record;
+	HARDWARE_EnableInterrupts(true);
+	if (Count == SCANLOG_RECORDS) {
+		SCANLOG_Flush();
+	}
+}
+
+void SCANLOG_Flush(void)
+{
+	const uint16_t Offset = offsetof(ScanLogPage_t, Records) + (Programmed * sizeof(ScanLogRecord_t));
+
+	if (Count == Programmed) {
+		return;
+	}
+
+	if (Programmed == 0) {
+		FLASHRING_Write(&Ring, CurrentPage, 0, &Page, offsetof(ScanLogPage_t, Records));
+	}
+	FLASHRING_Write(&Ring, CurrentPage, Offset, (const uint8_t *)&Page + Offset, (Count - Programmed) * sizeof(ScanLogRecord_t));
+
+	Programmed = Count;
+	if (Count == SCANLOG_RECORDS) {
+		StartPage((CurrentPage + 1) % SCANLOG_PAGES, Page.Sequence + 1);
+	}
+}
+
+void SCANLOG_Clear(void)
+{
+	FLASHRING_Clear(&Ring);
+	StartPage(0, 0);
+	bOpen = false;
+}
+
+// Reads 128 bytes of the log, two blocks per page. The page being filled comes from RAM, with
+// the records that are not programmed yet. Called from the UART interrupt.
+bool SCANLOG_ReadBlock(uint16_t Block, uint8_t *pBuffer)
+{
+	const uint8_t Index = Block / 2U;
+	const uint8_t Offset = (Block % 2U) * 128U;
+
+	if (Block >= SCANLOG_PAGES * 2U) {
+		return false;
+	}
+	if (Index == CurrentPage) {
+		memcpy(pBuffer, (const uint8_t *)&Page + Offset, 128);
+	} else {
+		SFLASH_Read(pBuffer, FLASHRING_GetAddress(&Ring, Index) + Offset, 128);
+	}
+
+	return true;
+}
+
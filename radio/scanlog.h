@@ -0,0 +1,67 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_SCANLOG_H
+#define RADIO_SCANLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "radio/channels.h"
+
+#define SCANLOG_PAGES		64U
+#define SCANLOG_RECORDS		15U
+#define SCANLOG_VFO		0xFFFFU
+
+// Why the scanner moved on
+enum {
+	SCANLOG_CARRIER = 0U,	// the dwell or resume delay ran out
+	SCANLOG_TIME,		// Time Operated resume
+	SCANLOG_FORCED,		// skipped with the up/down keys
+	SCANLOG_LOCKOUT,	// locked out
+	SCANLOG_PRIORITY,	// a priority channel took over
+	SCANLOG_STOPPED,	// scanning was turned off
+};
+
+// Time stays 0xFFFFFFFF in a free record, the whole record is programmed once.
+typedef struct __attribute__((packed)) {
+	uint32_t Time;		// STATS_GetClock() seconds when the scanner stopped
+	uint32_t Frequency;
+	uint16_t Channel;	// SCANLOG_VFO for the VFO and band scans
+	uint16_t Duration;	// 100 ms units of open squelch
+	uint16_t Code:12;	// CSS of the channel, matched for the scanner to stop
+	uint16_t CodeType:4;
+	uint8_t Rssi;		// peak, dBm + 160
+	uint8_t Reason;
+} ScanLogRecord_t;
+
+// One log page is exactly one flash page, the same layout is returned by UART command 0x57.
+typedef struct {
+	uint32_t Magic;
+	uint32_t Sequence;
+	uint8_t Reserved[8];
+	ScanLogRecord_t Records[SCANLOG_RECORDS];
+} ScanLogPage_t;
+
+void SCANLOG_Init(void);
+void SCANLOG_Start(uint16_t Channel, const FrequencyInfo_t *pInfo);
+void SCANLOG_UpdateRX(uint16_t Rssi);
+void SCANLOG_End(uint8_t Reason);
+void SCANLOG_Flush(void);
+void SCANLOG_Clear(void);
+bool SCANLOG_ReadBlock(uint16_t Block, uint8_t *pBuffer);
+
+#endif
+
@@ -29,6 +29,7 @@ enum {
 	TASK_FM_SCANNER       = 0x0020U,
 	TASK_CHECK_INCOMING   = 0x0040U,
 	TASK_CHECK_RSSI       = 0x0080U,
+	TASK_SPECTRUM         = 0x0100U,
 	TASK_CHECK_KEY_PAD    = 0x0200U,
 	TASK_CHECK_SIDE_KEYS  = 0x0400U,
 	TASK_VOX              = 0x0800U,
@@ -22,7 +22,10 @@
 #include "helper/dtmf.h"
 #include "misc.h"
 #include "radio/hardware.h"
+#include "radio/lockout.h"
+#include "radio/scanlog.h"
 #include "radio/settings.h"
+#include "radio/stats.h"
 #include "task/keyaction.h"
 #include "task/scanner.h"
 #include "ui/gfx.h"
@@ -167,6 +170,10 @@ void SETTINGS_FactoryReset(void)
 	SFLASH_Read(&gSettings, 0x3C1030, sizeof(gSettings));
 	gSettings.bFLock = Lock;
 	SETTINGS_SaveGlobals();
+	CHANNELS_InvalidateIndex();
+	STATS_Clear();
+	LOCKOUT_Clear();
+	SCANLOG_Clear();
 }
 
 void SETTINGS_SaveDeviceName(void)
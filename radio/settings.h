@@ -169,8 +169,27 @@ typedef struct __attribute__((packed)) {
 	uint8_t KeyShortcut[14];
 	// 0x0F
 	uint8_t ScanAll: 1;
-	uint8_t Undefined: 7;	// free for use
-	// 0x10...
+	uint8_t ScanRate: 3;	// index into the scanner rates XOR 5 (erased: 8 ch/s, the stock 128 ms hop)
+	uint8_t PriorityScanOff: 1;	// no priority look-backs (erased: priority scan off)
+	uint8_t ScanActiveFirstOff: 1;	// channel order only (erased: active first off)
+	uint8_t Undefined: 2;	// free for use
+	// 0x10
+	uint8_t LockoutTime: 3;	// index into the lockout durations XOR 7 (erased: 1 minute)
+	uint8_t LockoutKeepOff: 1;	// lockouts are dropped at power on (erased: dropped)
+	uint8_t BandScan: 1;	// VFO scan between BandScanLower and BandScanUpper
+	uint8_t ScanMerged: 1;	// scan the lists of ScanListSkip together
+	uint8_t Undefined1: 2;	// free for use
+	// 0x11 - 0x19
+	uint32_t BandScanLower;
+	uint32_t BandScanUpper;
+	uint8_t BandScanStep;	// FREQUENCY_GetStep() index
+	// 0x1A
+	uint8_t ScanListSkip;	// lists left out of the merged scan, 1 bit per list (erased: all)
+	// 0x1B
+	uint8_t WatchTime: 3;	// index into the dual watch timings, 7 is the stock 150/150 ms
+	uint8_t SpectrumWatchOff: 1;	// no home VFO checks in the spectrum (erased: off)
+	uint8_t Undefined2: 4;	// free for use
+	// 0x1C...
 } gExtendedSettings_t;
 
 extern Calibration_t gCalibration;
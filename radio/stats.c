@@ -0,0 +1,206 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "driver/serial-flash.h"
+#include "radio/flash-ring.h"
+#include "radio/scheduler.h"
+#include "radio/stats.h"
+
+// Receive statistics of the most active memory channels, kept like the spectrum activity log:
+// two sectors of page sized images, each flush programs the next free page.
+#define STATS_ADDRESS		0x3E6000U
+#define STATS_SECTORS		2U
+#define STATS_SLOTS		(STATS_SECTORS * 0x1000U / sizeof(StatsLog_t))
+#define STATS_MAGIC		0x31545343U // "CST1"
+
+#define STATS_FLUSH_INTERVAL	60U
+#define STATS_NONE		0xFFFFU
+
+StatsLog_t gStatsLog;
+
+static const FlashRing_t Ring = { STATS_ADDRESS, STATS_MAGIC, sizeof(StatsLog_t), STATS_SLOTS };
+
+static uint32_t ClockBase;
+static uint32_t LastFlush;
+static uint32_t RxStart;
+static uint16_t RxChannel = STATS_NONE;
+static uint8_t NextSlot;
+static bool bDirty;
+
+static void ResetLog(void)
+{
+	gStatsLog.Magic = STATS_MAGIC;
+	gStatsLog.Sequence = 0;
+	gStatsLog.Clock = 0;
+	gStatsLog.Count = 0;
+	NextSlot = 0;
+}
+
+// Ranks entries by hits, then by time spent receiving.
+static bool IsMoreActive(const StatsEntry_t *pA, const StatsEntry_t *pB)
+{
+	if (pA->Hits != pB->Hits) {
+		return pA->Hits > pB->Hits;
+	}
+
+	return pA->RxTime > pB->RxTime;
+}
+
+static StatsEntry_t *GetEntry(uint16_t Channel)
+{
+	StatsEntry_t *pEntry;
+	uint8_t i;
+
+	for (i = 0; i < gStatsLog.Count; i++) {
+		if (gStatsLog.Entries[i].Channel == Channel) {
+			return &gStatsLog.Entries[i];
+		}
+	}
+
+	if (gStatsLog.Count < STATS_MAX_ENTRIES) {
+		pEntry = &gStatsLog.Entries[gStatsLog.Count++];
+	} else {
+		// Full, the least active entry makes room, the oldest one among equals.
+		pEntry = &gStatsLog.Entries[0];
+		for (i = 1; i < STATS_MAX_ENTRIES; i++) {
+			const StatsEntry_t *pOther = &gStatsLog.Entries[i];
+
+			if (IsMoreActive(pEntry, pOther) || (!IsMoreActive(pOther, pEntry) && pOther->LastHeard < pEntry->LastHeard)) {
+				pEntry = &gStatsLog.Entries[i];
+			}
+		}
+	}
+
+	pEntry->Channel = Channel;
+	pEntry->Hits = 0;
+	pEntry->RxTime = 0;
+	pEntry->LastHeard = 0;
+
+	return pEntry;
+}
+
+void STATS_Init(void)
+{
+	uint32_t Sequence;
+	const uint8_t Latest = FLASHRING_FindLatest(&Ring, &Sequence);
+
+	if (Latest < STATS_SLOTS) {
+		SFLASH_Read(&gStatsLog, FLASHRING_GetAddress(&Ring, Latest), sizeof(gStatsLog));
+		NextSlot = (Latest + 1) % STATS_SLOTS;
+	}
+	if (Latest == STATS_SLOTS || gStatsLog.Count > STATS_MAX_ENTRIES) {
+		ResetLog();
+	}
+
+	// The clock is the epoch of LastHeard, it keeps counting from the last flush.
+	ClockBase = gStatsLog.Clock;
+	LastFlush = ClockBase;
+	bDirty = false;
+}
+
+uint32_t STATS_GetClock(void)
+{
+	return ClockBase + (gTimeSinceBoot / 1000U);
+}
+
+void STATS_StartRX(uint16_t Channel)
+{
+	StatsEntry_t *pEntry = GetEntry(Channel);
+	uint8_t i;
+
+	if (pEntry->Hits == 0xFFFF) {
+		// Halving keeps the ranking and lets old traffic fade.
+		for (i = 0; i < gStatsLog.Count; i++) {
+			gStatsLog.Entries[i].Hits /= 2;
+		}
+	}
+	pEntry->Hits++;
+	pEntry->LastHeard = STATS_GetClock();
+	RxChannel = Channel;
+	RxStart = gTimeSinceBoot;
+	bDirty = true;
+}
+
+void STATS_EndRX(void)
+{
+	uint8_t i;
+
+	if (RxChannel == STATS_NONE) {
+		return;
+	}
+	for (i = 0; i < gStatsLog.Count; i++) {
+		if (gStatsLog.Entries[i].Channel == RxChannel) {
+			gStatsLog.Entries[i].RxTime += (gTimeSinceBoot - RxStart + 500U) / 1000U;
+			gStatsLog.Entries[i].LastHeard = STATS_GetClock();
+			break;
+		}
+	}
+	RxChannel = STATS_NONE;
+}
+
+void STATS_Flush(bool bForce)
+{
+	const uint32_t Now = STATS_GetClock();
+
+	if (!bDirty || (!bForce && Now - LastFlush < STATS_FLUSH_INTERVAL)) {
+		return;
+	}
+
+	gStatsLog.Sequence++;
+	gStatsLog.Clock = Now;
+	FLASHRING_Write(&Ring, NextSlot, 0, &gStatsLog, sizeof(gStatsLog));
+
+	NextSlot = (NextSlot + 1) % STATS_SLOTS;
+	LastFlush = Now;
+	bDirty = false;
+}
+
+void STATS_Clear(void)
+{
+	FLASHRING_Clear(&Ring);
+	ResetLog();
+	ClockBase = 0;
+	LastFlush = 0;
+	RxChannel = STATS_NONE;
+	bDirty = false;
+}
+
+// Fills pChannels with up to Max channels, the most active first.
+uint8_t STATS_GetMostActive(uint16_t *pChannels, uint8_t Max)
+{
+	const StatsEntry_t *pRanked[STATS_MAX_ENTRIES];
+	uint8_t Count = 0;
+	uint8_t i, j;
+
+	for (i = 0; i < gStatsLog.Count; i++) {
+		const StatsEntry_t *pEntry = &gStatsLog.Entries[i];
+
+		for (j = Count; j > 0 && IsMoreActive(pEntry, pRanked[j - 1]); j--) {
+			pRanked[j] = pRanked[j - 1];
+		}
+		pRanked[j] = pEntry;
+		Count++;
+	}
+
+	if (Count > Max) {
+		Count = Max;
+	}
+	for (i = 0; i < Count; i++) {
+		pChannels[i] = pRanked[i]->Channel;
+	}
+
+	return Count;
+}
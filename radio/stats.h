@@ -0,0 +1,53 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_STATS_H
+#define RADIO_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STATS_MAX_ENTRIES 20
+
+typedef struct {
+	uint16_t Channel;
+	uint16_t Hits;
+	uint32_t RxTime;	// seconds
+	uint32_t LastHeard;	// STATS_GetClock() seconds
+} StatsEntry_t;
+
+// One log image is exactly one flash page, the same layout is returned by UART command 0x56.
+typedef struct {
+	uint32_t Magic;
+	uint32_t Sequence;
+	uint32_t Clock;
+	uint8_t Count;
+	uint8_t Reserved[3];
+	StatsEntry_t Entries[STATS_MAX_ENTRIES];
+} StatsLog_t;
+
+extern StatsLog_t gStatsLog;
+
+void STATS_Init(void);
+uint32_t STATS_GetClock(void);
+void STATS_StartRX(uint16_t Channel);
+void STATS_EndRX(void);
+void STATS_Flush(bool bForce);
+void STATS_Clear(void);
+uint8_t STATS_GetMostActive(uint16_t *pChannels, uint8_t Max);
+
+#endif
+
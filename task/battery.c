@@ -44,14 +44,18 @@ void Task_CheckBattery(void)
 			&& gFM_Mode == FM_MODE_OFF
 			&& gScreenMode == SCREEN_MAIN
 			&& !gDTMF_InputMode
-			&& !gFlashlightMode) {
+			&& !gFlashlightMode
+			&& !gSpectrumMode) {
 		UI_DrawVoltage(!gSettings.CurrentVfo);
 	}
-	UI_DrawBattery(!gSettings.RepeaterMode);
+	// The spectrum draws its own battery gauge
+	if (!gSpectrumMode) {
+		UI_DrawBattery(!gSettings.RepeaterMode);
+	}
 
 	if (BatteryLevel && ChargeTimer++ >= 30) {
 		ChargeTimer = 0;
-		if (gScreenMode == SCREEN_MAIN) {
+		if (gScreenMode == SCREEN_MAIN && !gSpectrumMode) {
 			UI_DrawDialogText(DIALOG_PLEASE_CHARGE, true);
 		}
 	}
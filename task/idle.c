@@ -16,6 +16,12 @@
 
 #include "app/fm.h"
 #include "app/radio.h"
+#ifdef UART_DEBUG
+	#include "bsp/gpio.h"
+	#include "driver/crm.h"
+	#include "driver/delay.h"
+	#include "driver/uart.h"
+#endif
 #include "driver/speaker.h"
 #include "misc.h"
 #include "radio/scheduler.h"
@@ -23,9 +29,63 @@
 #include "task/idle.h"
 #include "task/vox.h"
 
+// Dual watch time on the home VFO and on the other one in ms, by gExtendedSettings.WatchTime
+static const uint16_t WatchTimes[8][2] = {
+	{  50,  50 },
+	{ 100,  50 },
+	{ 100, 100 },
+	{ 200,  50 },
+	{ 200, 100 },
+	{ 300, 100 },
+	{ 500, 100 },
+	{ 150, 150 },
+};
+
+#ifdef UART_DEBUG
+// Switch times in CPU cycles, full tunes and fast switches, reported every WATCH_REPORT switches.
+#define WATCH_REPORT	32
+
+static DELAY_Cycles_t WatchCycles[2];
+static uint16_t WatchSwitches;
+
+static void ReportWatch(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < 2; i++) {
+		if (WatchCycles[i].Count) {
+			UART_printf("Watch %s: %u switches, %lu us average, %lu us max\r\n",
+				i ? "fast" : "full",
+				WatchCycles[i].Count,
+				(unsigned long)(WatchCycles[i].Sum / WatchCycles[i].Count / (gSystemCoreClock / 1000000U)),
+				(unsigned long)(WatchCycles[i].Max / (gSystemCoreClock / 1000000U)));
+		}
+		WatchCycles[i].Sum = 0;
+		WatchCycles[i].Max = 0;
+		WatchCycles[i].Count = 0;
+	}
+}
+#endif
+
+static void SwitchWatch(uint8_t Vfo)
+{
+#ifdef UART_DEBUG
+	const uint32_t Start = DELAY_StartCycles();
+	const bool bFast = RADIO_WatchTune(Vfo);
+
+	DELAY_CountCycles(&WatchCycles[bFast], Start);
+	if (++WatchSwitches == WATCH_REPORT) {
+		WatchSwitches = 0;
+		ReportWatch();
+	}
+#else
+	RADIO_WatchTune(Vfo);
+#endif
+}
+
 void Task_Idle(void)
 {
-	if (gRadioMode != RADIO_MODE_RX && gRadioMode != RADIO_MODE_TX && VOX_Counter == 0 && gRxLinkCounter == 0 && !gScannerMode && !gReceptionMode && !gMonitorMode && !gEnableLocalAlarm && gFM_Mode == FM_MODE_OFF && gSaveModeTimer == 0 && SPEAKER_State == 0) {
+	if (gRadioMode != RADIO_MODE_RX && gRadioMode != RADIO_MODE_TX && VOX_Counter == 0 && gRxLinkCounter == 0 && !gScannerMode && !gSpectrumMode && !gReceptionMode && !gMonitorMode && !gEnableLocalAlarm && gFM_Mode == FM_MODE_OFF && gSaveModeTimer == 0 && SPEAKER_State == 0) {
 		switch (gIdleMode) {
 		case IDLE_MODE_OFF:
 #ifdef ENABLE_NOAA
@@ -38,7 +98,7 @@ void Task_Idle(void)
 #ifdef ENABLE_NOAA
 			gNoaaMode = false;
 #endif
-			RADIO_Tune(!gSettings.CurrentVfo);
+			SwitchWatch(!gSettings.CurrentVfo);
 #ifdef ENABLE_NOAA
 			if (gSettings.NoaaAlarm) {
 				gIdleMode = IDLE_MODE_NOAA;
@@ -49,7 +109,7 @@ void Task_Idle(void)
 			} else {
 				gIdleMode = IDLE_MODE_OFF;
 			}
-			gSaveModeTimer = 150;
+			gSaveModeTimer = WatchTimes[gExtendedSettings.WatchTime][1];
 			break;
 
 #ifdef ENABLE_NOAA
@@ -99,7 +159,7 @@ void IDLE_SelectMode(void)
 #else
 	if (gSettings.DualStandby) {
 #endif
-		RADIO_Tune(gSettings.CurrentVfo);
+		SwitchWatch(gSettings.CurrentVfo);
 	}
 	if (gSettings.DualStandby) {
 		gIdleMode = IDLE_MODE_DUAL_STANDBY;
@@ -110,6 +170,6 @@ void IDLE_SelectMode(void)
 	} else if (gSettings.SaveMode) {
 		gIdleMode = IDLE_MODE_SAVE;
 	}
-	gSaveModeTimer = 150;
+	gSaveModeTimer = gSettings.DualStandby ? WatchTimes[gExtendedSettings.WatchTime][0] : 150;
 }
 
@@ -26,7 +26,7 @@
 
 void Task_CheckIncoming(void)
 {
-	if ((gFM_Mode == FM_MODE_OFF || gSettings.FmStandby) && gRadioMode != RADIO_MODE_TX && !gSaveMode && SCHEDULER_CheckTask(TASK_CHECK_INCOMING) && gIncomingTimer == 0) {
+	if ((gFM_Mode == FM_MODE_OFF || gSettings.FmStandby) && gRadioMode != RADIO_MODE_TX && !gSaveMode && !gSpectrumMode && SCHEDULER_CheckTask(TASK_CHECK_INCOMING) && gIncomingTimer == 0) {
 		bool bGotLink;
 
 		SCHEDULER_ClearTask(TASK_CHECK_INCOMING);
@@ -74,6 +74,36 @@ void SetDefaultKeyShortcuts(uint8_t IncludeSideKeys) {
 	SETTINGS_SaveGlobals();
 }
 
+// Switches from VFO mode to the memory channel with the closest RX frequency.
+static void FindChannel(void)
+{
+	uint16_t Channel = 0xFFFF;
+
+	if (!gSettings.WorkMode) {
+		Channel = CHANNELS_FindByFrequency(gVfoState[gSettings.CurrentVfo].RX.Frequency);
+	}
+	if (Channel == 0xFFFF) {
+		BEEP_Play(440, 4, 80);
+		return;
+	}
+
+	gFrequencyReverse = false;
+	gInputBoxWriteIndex = 0;
+	RADIO_CancelMode();
+	gSettings.VfoChNo[gSettings.CurrentVfo] = Channel;
+	gSettings.WorkMode = 1;
+	SETTINGS_SaveGlobals();
+	CHANNELS_LoadWorkMode();
+	RADIO_Tune(gSettings.CurrentVfo);
+	if (gSettings.DualDisplay == 0) {
+		UI_DrawVfo(gSettings.CurrentVfo);
+	} else {
+		UI_DrawVfo(0);
+		UI_DrawVfo(1);
+	}
+	BEEP_Play(740, 2, 100);
+}
+
 void KeypressAction(uint8_t Action) {
 	if (gSettings.Lock && Action != ACTION_LOCK) {
 		return;
@@ -88,6 +118,19 @@ void KeypressAction(uint8_t Action) {
 		return;
 	}
 
+#ifdef ENABLE_SPECTRUM
+	if (gSpectrumMode) {
+		if (Action == ACTION_SPECTRUM) {
+			SPECTRUM_Exit();
+		} else if (Action == ACTION_LOCK) {
+			LOCK_Toggle();
+		} else if (Action == ACTION_SNAPSHOT) {
+			SPECTRUM_SaveSnapshot();
+		}
+		return;
+	}
+#endif
+
 	if (gFrequencyDetectMode || gRadioMode == RADIO_MODE_TX) {
 		return;
 	}
@@ -215,6 +258,10 @@ void KeypressAction(uint8_t Action) {
 				gManualScanDirection = gSettings.ScanDirection;
 				gScannerMode ^= 1;
 				bBeep740 = gScannerMode;
+				RADIO_ClearScanTunes();
+				if (gScannerMode) {
+					SCANNER_PreparePriority();
+				}
 				SCANNER_Countdown = 50;
 				UI_DrawScan();
 				break;
@@ -370,11 +417,16 @@ void KeypressAction(uint8_t Action) {
 		        UI_SetColors(gExtendedSettings.DarkMode);
                 UI_DrawMain(FALSE);
                 break;
+
+			case ACTION_FIND_CHANNEL:
+				FindChannel();
+				break;
 			
 #ifdef ENABLE_SPECTRUM
 			case ACTION_SPECTRUM:
 				gInputBoxWriteIndex = 0;
 				APP_Spectrum();
+				break;
 #endif
 
 		}
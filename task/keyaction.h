@@ -46,6 +46,8 @@ enum {
 	ACTION_LOCK,
 	ACTION_SPECTRUM,
 	ACTION_DARK_MODE,
+	ACTION_FIND_CHANNEL,		// switch from the VFO to the channel closest to its frequency
+	ACTION_SNAPSHOT,			// save a snapshot of the spectrum sweep
 	ACTIONS_COUNT,	// used to count the number of actions, keep this last
 };
 
@@ -33,6 +33,7 @@
 #ifdef ENABLE_NOAA
 	#include "task/noaa.h"
 #endif
+#include "task/scanner.h"
 #include "task/screen.h"
 #include "ui/dialog.h"
 #include "ui/gfx.h"
@@ -90,6 +91,10 @@ static void MAIN_KeyHandler(KEY_t Key)
 
 	VOX_Timer = 0;
 	Task_UpdateScreen();
+	if (gScannerMode && Key == KEY_STAR && SCANNER_Lockout()) {
+		BEEP_Play(740, 2, 100);
+		return;
+	}
 	if (gScannerMode && Key != KEY_UP && Key != KEY_DOWN) {
 		SETTINGS_SaveState();
 		return;
@@ -401,7 +406,7 @@ static void HandlerLong(KEY_t Key)
 
 void Task_CheckKeyPad(void)
 {
-	if (SCHEDULER_CheckTask(TASK_CHECK_KEY_PAD) && gSettings.DtmfState == DTMF_STATE_NORMAL) {
+	if (SCHEDULER_CheckTask(TASK_CHECK_KEY_PAD) && gSettings.DtmfState == DTMF_STATE_NORMAL && !gSpectrumMode) {
 		KEY_t Key;
 
 		SCHEDULER_ClearTask(TASK_CHECK_KEY_PAD);
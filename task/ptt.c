@@ -17,6 +17,9 @@
 #include "app/flashlight.h"
 #include "app/fm.h"
 #include "app/radio.h"
+#ifdef ENABLE_SPECTRUM
+	#include "app/spectrum.h"
+#endif
 #include "driver/beep.h"
 #include "driver/pins.h"
 #include "helper/helper.h"
@@ -56,6 +59,15 @@ void Task_CheckPTT(void)
 				return;
 			}
 			SCREEN_TurnOn();
+#ifdef ENABLE_SPECTRUM
+			if (gSpectrumMode) {
+				// PTT leaves the spectrum, the next press transmits on the VFO
+				SPECTRUM_Exit();
+				gPttPressed = true;
+				BEEP_Play(440, 4, 80);
+				return;
+			}
+#endif
 			if (gFM_Mode == FM_MODE_OFF) {
 				if (!gScannerMode) {
 					if (!gReceptionMode) {
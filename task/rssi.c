@@ -139,7 +139,7 @@ static void CheckRSSI(void)
 
 void Task_CheckRSSI(void)
 {
-	if (gRadioMode != RADIO_MODE_TX && gRadioMode != RADIO_MODE_QUIET && !gSaveMode && SCHEDULER_CheckTask(TASK_CHECK_RSSI)) {
+	if (gRadioMode != RADIO_MODE_TX && gRadioMode != RADIO_MODE_QUIET && !gSaveMode && !gSpectrumMode && SCHEDULER_CheckTask(TASK_CHECK_RSSI)) {
 		uint8_t Status;
 
 		SCHEDULER_ClearTask(TASK_CHECK_RSSI);
@@ -16,53 +16,501 @@
 
 #include "app/radio.h"
 #include "bsp/gpio.h"
+#include "driver/bk4819.h"
+#include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
+#ifdef UART_DEBUG
+	#include "driver/serial-flash.h"
+	#include "driver/uart.h"
+#endif
 #include "misc.h"
 #include "radio/channels.h"
+#include "radio/frequencies.h"
+#include "radio/lockout.h"
+#include "radio/scanlog.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/scanner.h"
 #include "ui/helper.h"
+#include "ui/main.h"
+#include "ui/vfo.h"
+
+// A channel is first sampled SCAN_SETTLE_MS after the hop, once the PLL has settled. Clearly
+// empty channels are left right there, borderline readings are sampled again after up to
+// SCAN_EXTENSIONS dwells of the Scan Rate and an open squelch is held long enough for the tone
+// decoder. The VFO of a band scan is drawn when the scan stops on something or once per second.
+#define SCAN_SETTLE_MS		6
+#define SCAN_EXTENSIONS		3
+#define SCAN_BUSY_MS		250
+
+// The RSSI peak of a logged stop is sampled at this interval
+#define SCAN_RSSI_MS		10
+
+enum {
+	SCAN_EMPTY = 0U,
+	SCAN_BORDERLINE,
+	SCAN_BUSY,
+};
+
+// By gExtendedSettings.ScanRate XOR 5
+static const uint8_t ScanRates[8] = { 4, 6, 8, 10, 15, 20, 25, 30 };
+
+// Seconds a lockout lasts, by gExtendedSettings.LockoutTime XOR 7
+static const uint32_t LockoutTimes[8] = { 60, 300, 900, 1800, 3600, 7200, 14400, LOCKOUT_FOREVER };
+
+// The preset channels are the priority channels, the first one ranks highest. They are looked
+// at every PRIORITY_INTERVAL_MS, PRIORITY_DWELL_MS each, with the squelch link as the only test.
+#define PRIORITY_COUNT		4
+#define PRIORITY_INTERVAL_MS	2000
+#define PRIORITY_DWELL_MS	8
+#define PRIORITY_NONE		0xFF
+
+static uint8_t Extensions;
+static uint8_t HopCount;
+static uint32_t RateTime;
+static bool bVfoStale;
+
+static RADIO_FastTune_t PriorityTunes[PRIORITY_COUNT];
+static uint8_t PriorityMask;
+static uint8_t PrioritySlot = PRIORITY_NONE;
+static uint32_t PriorityTime;
+static ChannelInfo_t ParkedVfo;
+static uint16_t ParkedChannel;
+static uint32_t RssiTime;
+static bool bScanning;
+static bool bStopped;
+static bool bLockedOut;
+
+#ifdef UART_DEBUG
+// Hop latency in core cycles, split by whether the prefetch had the hop ready
+static DELAY_Cycles_t HopCycles[2];
+static uint32_t FlashBytes;
+static uint32_t Transactions;
+static uint32_t HopTime;
+static uint32_t StopTime;
+#endif
 
 uint16_t SCANNER_Countdown;
 
+static uint16_t GetDwell(void)
+{
+	return 1000 / ScanRates[gExtendedSettings.ScanRate ^ 5U];
+}
+
+static uint8_t CheckChannel(void)
+{
+	// Close thresholds: RSSI in the low byte of 0x78, noise in the high byte of 0x4F
+	const uint8_t RssiClose = BK4819_ReadRegister(0x78) & 0xFFU;
+	const uint8_t NoiseClose = BK4819_ReadRegister(0x4F) >> 8;
+
+	if (BK4819_CheckSquelchLink()) {
+		return SCAN_BUSY;
+	}
+	if (BK4819_GetRSSI() < RssiClose && BK4819_GetNoise() > NoiseClose) {
+		return SCAN_EMPTY;
+	}
+
+	return SCAN_BORDERLINE;
+}
+
+static void DrawStaleVfo(void)
+{
+	if (bVfoStale && gScreenMode == SCREEN_MAIN) {
+		UI_DrawVfo(gSettings.CurrentVfo);
+	}
+	bVfoStale = false;
+}
+
+static bool HoldChannel(void)
+{
+	const uint8_t Level = CheckChannel();
+
+	if (Level == SCAN_EMPTY || Extensions >= SCAN_EXTENSIONS) {
+		return false;
+	}
+	DrawStaleVfo();
+	if (Level == SCAN_BUSY) {
+		Extensions = SCAN_EXTENSIONS;
+		SCANNER_Countdown = SCAN_BUSY_MS;
+	} else {
+		Extensions++;
+		SCANNER_Countdown = GetDwell();
+	}
+
+	return true;
+}
+
+// Priority channels ranked below the one being received are not looked at.
+static uint32_t GetLockoutKey(void)
+{
+	if (gSettings.WorkMode) {
+		return gSettings.VfoChNo[gSettings.CurrentVfo];
+	}
+
+	return gVfoState[gSettings.CurrentVfo].RX.Frequency;
+}
+
+static uint8_t GetPriorityRank(void)
+{
+	uint8_t i;
+
+	if (PrioritySlot != PRIORITY_NONE) {
+		return PrioritySlot;
+	}
+	if (gSettings.WorkMode) {
+		for (i = 0; i < PRIORITY_COUNT; i++) {
+			if (gSettings.PresetChannels[i] == gSettings.VfoChNo[gSettings.CurrentVfo]) {
+				return i;
+			}
+		}
+	}
+
+	return PRIORITY_COUNT;
+}
+
+static bool CheckPriorityLink(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < PRIORITY_DWELL_MS; i++) {
+		DELAY_WaitMS(1);
+		if (BK4819_CheckSquelchLink()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// The scanned channel or VFO is parked while a priority channel is received, the next hop
+// continues from it.
+static void SwitchToPriority(uint8_t Slot)
+{
+	const uint16_t Channel = gSettings.PresetChannels[Slot];
+
+	if (PrioritySlot == PRIORITY_NONE) {
+		ParkedVfo = gVfoState[gSettings.CurrentVfo];
+		ParkedChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
+	}
+	PrioritySlot = Slot;
+
+	if (bStopped) {
+		bStopped = false;
+		SCANLOG_End(SCANLOG_PRIORITY);
+	}
+	if (gRadioMode == RADIO_MODE_RX) {
+		RADIO_EndRX();
+	}
+	if (gSettings.WorkMode) {
+		gSettings.VfoChNo[gSettings.CurrentVfo] = Channel;
+	}
+	CHANNELS_LoadChannel(Channel, gSettings.CurrentVfo);
+	RADIO_Tune(gSettings.CurrentVfo);
+	UI_DrawVfo(gSettings.CurrentVfo);
+	SCANNER_Countdown = SCAN_BUSY_MS;
+	Extensions = SCAN_EXTENSIONS;
+}
+
+static void RestoreParked(void)
+{
+	if (PrioritySlot == PRIORITY_NONE) {
+		return;
+	}
+	PrioritySlot = PRIORITY_NONE;
+	if (gSettings.WorkMode) {
+		gSettings.VfoChNo[gSettings.CurrentVfo] = ParkedChannel;
+	}
+	gVfoState[gSettings.CurrentVfo] = ParkedVfo;
+}
+
+static void LookBack(void)
+{
+	const uint8_t Rank = GetPriorityRank();
+	const uint16_t Bandwidth = BK4819_ReadRegister(0x43);
+	RADIO_FastTune_t Home;
+	uint16_t Af = 0;
+	uint8_t Found = PRIORITY_NONE;
+	uint8_t i;
+
+	if (!(PriorityMask & ((1U << Rank) - 1U))) {
+		return;
+	}
+
+	RADIO_PrepareFastTune(gMainVfo, &Home);
+	if (gRadioMode == RADIO_MODE_RX) {
+		Af = BK4819_ReadRegister(0x47);
+		BK4819_SetAF(BK4819_AF_MUTE);
+	}
+	for (i = 0; i < Rank; i++) {
+		if ((PriorityMask & (1U << i)) && !LOCKOUT_Check(gSettings.PresetChannels[i])) {
+			RADIO_FastTune(&PriorityTunes[i]);
+			if (CheckPriorityLink()) {
+				Found = i;
+				break;
+			}
+		}
+	}
+	RADIO_FastTune(&Home);
+	BK4819_WriteRegister(0x43, Bandwidth);
+	if (Af) {
+		BK4819_WriteRegister(0x47, Af);
+	}
+	gRxLinkCounter = 0;
+
+	if (Found != PRIORITY_NONE) {
+		SwitchToPriority(Found);
+	}
+}
+
+static void CheckPriority(void)
+{
+	if (!PriorityMask || !gScannerMode || gRadioMode == RADIO_MODE_TX) {
+		return;
+	}
+	if (gTimeSinceBoot - PriorityTime < PRIORITY_INTERVAL_MS) {
+		return;
+	}
+	PriorityTime = gTimeSinceBoot;
+	LookBack();
+}
+
+#ifdef UART_DEBUG
+// Once per second: the hop rate, what the hops cost in flash bytes read and BK4819 register
+// accesses (everything else running meanwhile included), then the hop latencies.
+static void ReportScan(uint16_t Hops)
+{
+	uint8_t i;
+
+	if (Hops) {
+		UART_printf("Scan: %u hops, %lu flash bytes and %lu BK4819 transactions per hop\r\n",
+			Hops,
+			(unsigned long)((gSFLASH_ReadBytes - FlashBytes) / Hops),
+			(unsigned long)((gBK4819_Transactions - Transactions) / Hops));
+	}
+	FlashBytes = gSFLASH_ReadBytes;
+	Transactions = gBK4819_Transactions;
+
+	for (i = 0; i < 2; i++) {
+		if (HopCycles[i].Count) {
+			UART_printf("Hop %s: %u hops, %lu cycles average, %lu max\r\n",
+				i ? "prefetched" : "cold",
+				HopCycles[i].Count,
+				(unsigned long)(HopCycles[i].Sum / HopCycles[i].Count),
+				(unsigned long)HopCycles[i].Max);
+		}
+		HopCycles[i].Sum = 0;
+		HopCycles[i].Max = 0;
+		HopCycles[i].Count = 0;
+	}
+}
+#endif
+
+// A stop is logged from the squelch opening to the next hop. The log is flushed when scanning
+// is turned off. With UART_DEBUG, the detection latency (hop to squelch opening) and the resume
+// delay (from there to the next hop) are printed as they happen.
+static void LogStop(void)
+{
+	if (!gScannerMode) {
+		if (bScanning) {
+			bScanning = false;
+			if (bStopped) {
+				bStopped = false;
+				SCANLOG_End(SCANLOG_STOPPED);
+			}
+			SCANLOG_Flush();
+		}
+		return;
+	}
+	bScanning = true;
+	if (gRadioMode != RADIO_MODE_RX) {
+		return;
+	}
+	if (!bStopped) {
+		bStopped = true;
+		SCANLOG_Start(gSettings.WorkMode ? gSettings.VfoChNo[gSettings.CurrentVfo] : SCANLOG_VFO, &gVfoState[gSettings.CurrentVfo].RX);
+		RssiTime = gTimeSinceBoot - SCAN_RSSI_MS;
+#ifdef UART_DEBUG
+		StopTime = gTimeSinceBoot;
+		UART_printf("Scan: stopped %lu ms after the hop\r\n", (unsigned long)(StopTime - HopTime));
+#endif
+	}
+	if (gTimeSinceBoot - RssiTime >= SCAN_RSSI_MS) {
+		RssiTime = gTimeSinceBoot;
+		SCANLOG_UpdateRX(BK4819_GetRSSI());
+	}
+}
+
+static void LogHop(uint8_t Reason)
+{
+#ifdef UART_DEBUG
+	HopTime = gTimeSinceBoot;
+	if (bStopped) {
+		UART_printf("Scan: resumed %lu ms after the stop\r\n", (unsigned long)(HopTime - StopTime));
+	}
+#endif
+	if (bStopped) {
+		bStopped = false;
+		SCANLOG_End(Reason);
+	}
+}
+
+static void CountHop(void)
+{
+	const uint32_t Elapsed = gTimeSinceBoot - RateTime;
+
+	HopCount++;
+	if (Elapsed >= 1000) {
+		if (gScreenMode == SCREEN_MAIN) {
+			UI_DrawScanRate((HopCount * 1000U) / Elapsed);
+		}
+		DrawStaleVfo();
+#ifdef UART_DEBUG
+		ReportScan(HopCount);
+#endif
+		HopCount = 0;
+		RateTime = gTimeSinceBoot;
+	}
+}
+
+static void Hop(void)
+{
+	if (gSettings.WorkMode) {
+		if(!CHANNELS_NextChannelMr(gManualScanDirection ? KEY_DOWN : KEY_UP, !gExtendedSettings.ScanAll)) {
+			Next_ScanList();
+		}
+	} else if (CHANNELS_IsBandScan()) {
+		CHANNELS_NextBandScan(gManualScanDirection ? KEY_DOWN : KEY_UP);
+		RADIO_BandScanTune(gSettings.CurrentVfo);
+		bVfoStale = true;
+	} else {
+		CHANNELS_NextChannelVfo(gManualScanDirection ? KEY_DOWN : KEY_UP);
+		RADIO_Tune(gSettings.CurrentVfo);
+	}
+}
+
 void Task_Scanner(void) {
+#ifdef UART_DEBUG
+	uint32_t Cycles;
+	uint16_t Prefetched;
+#endif
+	uint8_t Reason;
+	uint8_t i;
+
+	if (!SCHEDULER_CheckTask(TASK_SCANNER)) {
+		return;
+	}
+	SCHEDULER_ClearTask(TASK_SCANNER);
+
+	LogStop();
+	if (gRadioMode == RADIO_MODE_RX || !gScannerMode) {
+		DrawStaleVfo();
+	}
+	CheckPriority();
 	if ((gRadioMode < (gExtendedSettings.ScanResume == 2 ? RADIO_MODE_TX : RADIO_MODE_RX) 	// Allows Task_Scanner in RX mode if ScanResume is set to Time Operated
 			&& gScannerMode
 			&& SCANNER_Countdown == 0
-			&& SCHEDULER_CheckTask(TASK_SCANNER)
 			)
 			|| gForceScan) {
-		SCHEDULER_ClearTask(TASK_SCANNER);
+		if (!gForceScan && gRadioMode != RADIO_MODE_RX && HoldChannel()) {
+			return;
+		}
+		if (bLockedOut) {
+			Reason = SCANLOG_LOCKOUT;
+		} else if (gForceScan) {
+			Reason = SCANLOG_FORCED;
+		} else if (gRadioMode == RADIO_MODE_RX) {
+			Reason = SCANLOG_TIME;
+		} else {
+			Reason = SCANLOG_CARRIER;
+		}
+		bLockedOut = false;
 		gForceScan = false;
 		if (gRadioMode == RADIO_MODE_RX) {	// Scanner timeout
 			RADIO_EndRX();
 		}
-		if (gSettings.WorkMode) {
-			if(!CHANNELS_NextChannelMr(gManualScanDirection ? KEY_DOWN : KEY_UP, !gExtendedSettings.ScanAll)) {
-				Next_ScanList();
+		RestoreParked();
+#ifdef UART_DEBUG
+		Cycles = DELAY_StartCycles();
+		Prefetched = CHANNELS_GetPrefetched();
+#endif
+		// Locked out channels are hopped over, at most the whole table in a row
+		for (i = 0; i <= LOCKOUT_COUNT; i++) {
+			Hop();
+			if (!LOCKOUT_Check(GetLockoutKey())) {
+				break;
 			}
-		} else {
-			CHANNELS_NextChannelVfo(gManualScanDirection ? KEY_DOWN : KEY_UP);
-			RADIO_Tune(gSettings.CurrentVfo);
 		}
-		SCANNER_Countdown = 50;
+#ifdef UART_DEBUG
+		DELAY_CountCycles(&HopCycles[gSettings.WorkMode && Prefetched == gSettings.VfoChNo[gSettings.CurrentVfo]], Cycles);
+#endif
+		LogHop(Reason);
+		SCANNER_Countdown = SCAN_SETTLE_MS;
+		Extensions = 0;
+		CountHop();
 		if (gExtendedSettings.ScanBlink) {
 			gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_GREEN);
 		}
+	} else if (gScannerMode && gSettings.WorkMode && gRadioMode != RADIO_MODE_TX && PrioritySlot == PRIORITY_NONE) {
+		// A parked priority channel is not where the next hop starts from
+		CHANNELS_Prefetch(gManualScanDirection ? KEY_DOWN : KEY_UP, !gExtendedSettings.ScanAll);
+	}
+}
+
+// Called when scanning starts. The band lookup of each priority channel happens here, a look-back
+// only replays the registers.
+void SCANNER_PreparePriority(void)
+{
+	ChannelInfo_t Info;
+	uint8_t i;
+
+	PriorityMask = 0;
+	PrioritySlot = PRIORITY_NONE;
+	PriorityTime = gTimeSinceBoot;
+	// BK4819_CheckSquelchLink() is always true with squelch 0
+	if (gExtendedSettings.PriorityScanOff || !gSettings.Squelch) {
+		return;
 	}
+	for (i = 0; i < PRIORITY_COUNT; i++) {
+		if (gSettings.PresetChannels[i] < 999 && !CHANNELS_ReadChannel(gSettings.PresetChannels[i], &Info)) {
+			RADIO_PrepareFastTune(&Info, &PriorityTunes[i]);
+			PriorityMask |= 1U << i;
+		}
+	}
+	if (PriorityMask) {
+		FREQUENCY_SelectBand(gVfoInfo[gCurrentVfo].Frequency);
+	}
+}
+
+// Locks out the channel or frequency the scanner stopped on for the configured time and moves
+// on. Returns false while hopping, nothing is locked out then. Lockouts are not tied to a scan
+// list.
+bool SCANNER_Lockout(void)
+{
+	if (!bStopped) {
+		return false;
+	}
+	LOCKOUT_Add(GetLockoutKey(), LockoutTimes[gExtendedSettings.LockoutTime ^ 7U]);
+	bLockedOut = true;
+	gForceScan = true;
+
+	return true;
 }
 
+// Lists 1 to 8, all channels, then the merged lists when some are selected.
 void Next_ScanList(void) {
 	if (gExtendedSettings.ScanAll) {
 		gExtendedSettings.ScanAll = 0;
+		gExtendedSettings.ScanMerged = 1;
+	} else if (CHANNELS_IsScanMerged()) {
+		gExtendedSettings.ScanMerged = 0;
 	} else {
 		gExtendedSettings.CurrentScanList = (gExtendedSettings.CurrentScanList + 1) % 8;
 		if (gExtendedSettings.CurrentScanList == 0) {
 			gExtendedSettings.ScanAll = 1;
 		}
 	}
+	RADIO_ClearScanTunes();
 	UI_DrawScan();
 }
 
@@ -17,11 +17,14 @@
 #ifndef TASK_SCANNER_H
 #define TASK_SCANNER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 extern uint16_t SCANNER_Countdown;
 
 void Task_Scanner(void);
+void SCANNER_PreparePriority(void);
+bool SCANNER_Lockout(void);
 void Next_ScanList(void);
 
 #endif
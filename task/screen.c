@@ -23,7 +23,7 @@
 
 void Task_UpdateScreen(void)
 {
-	if (VOX_Timer == 0 && gRedrawScreen) {
+	if (VOX_Timer == 0 && gRedrawScreen && !gSpectrumMode) {
 		gRedrawScreen = false;
 		if (!DATA_WasDataReceived()) {
 			if (gScreenMode == SCREEN_MAIN && !gReceptionMode) {
@@ -0,0 +1,31 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/spectrum.h"
+#include "misc.h"
+#include "radio/scheduler.h"
+#include "task/spectrum.h"
+
+void Task_Spectrum(void)
+{
+	if (!gSpectrumMode || !SCHEDULER_CheckTask(TASK_SPECTRUM)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_SPECTRUM);
+	SPECTRUM_Step();
+}
+
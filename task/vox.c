@@ -74,7 +74,7 @@ void VOX_Update(void)
 
 void Task_VoxUpdate(void)
 {
-	if (gSettings.Vox && gPttLock == 0 && !gSaveMode && gScreenMode == SCREEN_MAIN && VOX_Timer == 0) {
+	if (gSettings.Vox && gPttLock == 0 && !gSaveMode && !gSpectrumMode && gScreenMode == SCREEN_MAIN && VOX_Timer == 0) {
 		if (SCHEDULER_CheckTask(TASK_VOX) && gFM_Mode == FM_MODE_OFF && !gDTMF_InputMode) {
 			bool bFlag;
 
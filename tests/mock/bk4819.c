@@ -0,0 +1,135 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <string.h>
+#include "driver/bk4819.h"
+#include "mock/mock.h"
+#include "radio/scheduler.h"
+
+// The register transport of driver/bk4819.c is weakened by the Makefile, these take over.
+
+typedef struct {
+	uint32_t Frequency;
+	uint32_t OnTime;	// gTimeSinceBoot it switches on at
+	bool bOn;
+} Carrier_t;
+
+uint16_t gMockRegisters[128];
+uint32_t gMockBK4819Transactions;
+
+static Carrier_t Carriers[MOCK_CARRIER_COUNT];
+static MOCK_Write_t Trace[MOCK_TRACE_SIZE];
+static uint16_t TraceCount;
+static bool bTracing;
+
+static bool IsCarrierOn(void)
+{
+	const uint32_t Frequency = MOCK_BK4819_GetFrequency();
+	uint8_t i;
+
+	for (i = 0; i < MOCK_CARRIER_COUNT; i++) {
+		if (Carriers[i].bOn && Carriers[i].Frequency == Frequency && gTimeSinceBoot >= Carriers[i].OnTime) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MOCK_BK4819_Reset(void)
+{
+	memset(gMockRegisters, 0, sizeof(gMockRegisters));
+	memset(Carriers, 0, sizeof(Carriers));
+	TraceCount = 0;
+	bTracing = false;
+	gMockBK4819Transactions = 0;
+}
+
+void MOCK_BK4819_SetCarrierAt(uint32_t Frequency, uint32_t Time)
+{
+	uint8_t Free = MOCK_CARRIER_COUNT;
+	uint8_t i;
+
+	for (i = 0; i < MOCK_CARRIER_COUNT; i++) {
+		if (Carriers[i].Frequency == Frequency) {
+			Free = i;
+			break;
+		}
+		if (Carriers[i].Frequency == 0 && Free == MOCK_CARRIER_COUNT) {
+			Free = i;
+		}
+	}
+	if (Free < MOCK_CARRIER_COUNT) {
+		Carriers[Free].Frequency = Frequency;
+		Carriers[Free].OnTime = Time;
+		Carriers[Free].bOn = true;
+	}
+}
+
+void MOCK_BK4819_SetCarrier(uint32_t Frequency, bool bOn)
+{
+	MOCK_BK4819_SetCarrierAt(Frequency, bOn ? 0 : UINT32_MAX);
+}
+
+// The test flash has a frequency offset of 32768, so 0x38/0x39 hold the frequency itself
+uint32_t MOCK_BK4819_GetFrequency(void)
+{
+	return ((uint32_t)gMockRegisters[0x39] << 16) | gMockRegisters[0x38];
+}
+
+void MOCK_BK4819_StartTrace(void)
+{
+	TraceCount = 0;
+	bTracing = true;
+}
+
+uint16_t MOCK_BK4819_GetTrace(const MOCK_Write_t **ppTrace)
+{
+	*ppTrace = Trace;
+
+	return TraceCount;
+}
+
+uint16_t BK4819_ReadRegister(uint8_t Reg)
+{
+	const bool bCarrier = IsCarrierOn();
+
+	gMockBK4819Transactions++;
+	switch (Reg & 0x7FU) {
+	case 0x0C:
+		// Squelch link in bit 1
+		return bCarrier ? 0x0002U : 0x0000U;
+	case 0x65:
+		return bCarrier ? 0x0010U : 0x007FU;
+	case 0x67:
+		return bCarrier ? 0x0180U : 0x0020U;
+	default:
+		return gMockRegisters[Reg & 0x7FU];
+	}
+}
+
+void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+{
+	gMockBK4819Transactions++;
+	gMockRegisters[Reg & 0x7FU] = Data;
+	if (bTracing && TraceCount < MOCK_TRACE_SIZE) {
+		Trace[TraceCount].Reg = Reg;
+		Trace[TraceCount].Data = Data;
+		TraceCount++;
+	}
+}
+
@@ -0,0 +1,38 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "driver/delay.h"
+#include "mock/mock.h"
+
+// Waits pass in simulated time, a millisecond at a time
+
+void DELAY_Init(void)
+{
+}
+
+void DELAY_WaitUS(uint32_t Delay)
+{
+	(void)Delay;
+}
+
+void DELAY_WaitMS(uint16_t Delay)
+{
+	while (Delay--) {
+		MOCK_Tick();
+	}
+}
+
@@ -0,0 +1,60 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef TESTS_MOCK_DSP_H
+#define TESTS_MOCK_DSP_H
+
+#include <stdint.h>
+#include <string.h>
+
+// C models of the Cortex-M4 DSP instructions, with the operand order of CMSIS, and of the CMSIS
+// unaligned access macros. The host is little endian like the radio.
+
+static inline uint32_t MOCK_ReadUnaligned(const void *pAddress)
+{
+	uint32_t Value;
+
+	memcpy(&Value, pAddress, sizeof(Value));
+
+	return Value;
+}
+
+static inline void MOCK_WriteUnaligned(void *pAddress, uint32_t Value)
+{
+	memcpy(pAddress, &Value, sizeof(Value));
+}
+
+#define __UNALIGNED_UINT32_READ(addr)		MOCK_ReadUnaligned(addr)
+#define __UNALIGNED_UINT32_WRITE(addr, val)	MOCK_WriteUnaligned((addr), (val))
+
+// Bottom half of Lo, top half of Hi shifted left by Shift
+static inline uint32_t __PKHBT(uint32_t Lo, uint32_t Hi, uint32_t Shift)
+{
+	return (Lo & 0x0000FFFFU) | ((Hi << Shift) & 0xFFFF0000U);
+}
+
+// Both signed 16-bit products of X and Y added to Acc
+static inline uint32_t __SMLAD(uint32_t X, uint32_t Y, uint32_t Acc)
+{
+	const int32_t Lo = (int32_t)(int16_t)(X & 0xFFFFU) * (int16_t)(Y & 0xFFFFU);
+	const int32_t Hi = (int32_t)(int16_t)(X >> 16) * (int16_t)(Y >> 16);
+
+	return Acc + (uint32_t)Lo + (uint32_t)Hi;
+}
+
+#endif
+
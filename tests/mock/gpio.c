@@ -0,0 +1,90 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "bsp/gpio.h"
+#include "mock/mock.h"
+
+// Stands in for bsp/gpio.c and the SDK, the ports are never dereferenced. Inputs read high,
+// so no key is pressed.
+
+#define PORT_COUNT	4
+
+static const void *Ports[PORT_COUNT];
+static uint16_t Outputs[PORT_COUNT];
+
+static uint16_t *GetOutputs(const void *pPort)
+{
+	uint8_t i;
+
+	for (i = 0; i < PORT_COUNT && Ports[i] && Ports[i] != pPort; i++) {
+	}
+	if (i == PORT_COUNT) {
+		i = PORT_COUNT - 1;
+	}
+	Ports[i] = pPort;
+
+	return &Outputs[i];
+}
+
+bool MOCK_GPIO_IsSet(const void *pPort, uint16_t Pins)
+{
+	return (*GetOutputs(pPort) & Pins) == Pins;
+}
+
+void gpio_bits_flip(gpio_type *gpio, uint16_t pins)
+{
+	*GetOutputs(gpio) ^= pins;
+}
+
+void gpio_default_para_init_ex(gpio_init_type *init)
+{
+	init->gpio_pins = GPIO_PINS_ALL;
+	init->gpio_mode = GPIO_MODE_INPUT;
+	init->gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+	init->gpio_pull = GPIO_PULL_NONE;
+	init->gpio_drive_strength = GPIO_DRIVE_STRENGTH_MODERATE;
+}
+
+void gpio_init(gpio_type *gpio_x, gpio_init_type *gpio_init_struct)
+{
+	(void)gpio_x;
+	(void)gpio_init_struct;
+}
+
+void gpio_bits_set(gpio_type *gpio_x, uint16_t pins)
+{
+	*GetOutputs(gpio_x) |= pins;
+}
+
+void gpio_bits_reset(gpio_type *gpio_x, uint16_t pins)
+{
+	*GetOutputs(gpio_x) &= ~pins;
+}
+
+flag_status gpio_input_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+	(void)gpio_x;
+	(void)pins;
+
+	return SET;
+}
+
+flag_status gpio_output_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+	return MOCK_GPIO_IsSet(gpio_x, pins) ? SET : RESET;
+}
+
@@ -0,0 +1,62 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#ifndef TESTS_MOCK_H
+#define TESTS_MOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "radio/channels.h"
+
+#define MOCK_FLASH_SIZE		0x400000U
+#define MOCK_TRACE_SIZE		4096U
+#define MOCK_CARRIER_COUNT	8U
+
+typedef struct {
+	uint8_t Reg;
+	uint16_t Data;
+} MOCK_Write_t;
+
+// RAM image of the serial flash, erased by MOCK_FLASH_Reset(). SFLASH_Read() counts the bytes.
+extern uint8_t gMockFlash[MOCK_FLASH_SIZE];
+extern uint32_t gMockFlashReadBytes;
+
+void MOCK_FLASH_Reset(void);
+void MOCK_FLASH_WriteBands(void);
+void MOCK_FLASH_WriteChannel(uint16_t Channel, const ChannelInfo_t *pChannel);
+
+// BK4819 register file. Reads of 0x0C, 0x65 and 0x67 follow the carriers on the frequency
+// in 0x38/0x39, the others return what was last written. Writes are traced once started,
+// reads and writes are counted.
+extern uint16_t gMockRegisters[128];
+extern uint32_t gMockBK4819Transactions;
+
+void MOCK_BK4819_Reset(void);
+void MOCK_BK4819_SetCarrier(uint32_t Frequency, bool bOn);
+void MOCK_BK4819_SetCarrierAt(uint32_t Frequency, uint32_t Time);
+uint32_t MOCK_BK4819_GetFrequency(void);
+void MOCK_BK4819_StartTrace(void);
+uint16_t MOCK_BK4819_GetTrace(const MOCK_Write_t **ppTrace);
+
+// Output pins as last driven
+bool MOCK_GPIO_IsSet(const void *pPort, uint16_t Pins);
+
+// One 1 ms timer interrupt, DELAY_WaitMS() runs as many
+void MOCK_Tick(void);
+
+#endif
+
@@ -0,0 +1,88 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "misc.h"
+#include "mock/mock.h"
+#include "radio/scheduler.h"
+#include "task/scanner.h"
+
+// The timers of radio/scheduler.c, MOCK_Tick() is its interrupt handler without the keys,
+// beeps and the UART.
+
+static uint16_t SCHEDULER_Tasks;
+static uint16_t SCHEDULER_Counter;
+
+uint32_t gPttTimeout;
+uint16_t ENCRYPT_Timer;
+uint32_t STANDBY_Counter;
+uint32_t gTimeSinceBoot;
+uint16_t gGreenLedTimer;
+
+volatile uint16_t gSpecialTimer;
+uint16_t VOX_Timer;
+uint16_t gIncomingTimer;
+uint16_t gBatteryTimer;
+uint16_t gSaveModeTimer;
+uint32_t gIdleTimer;
+uint16_t gDetectorTimer;
+
+bool SCHEDULER_CheckTask(uint16_t Task)
+{
+	return (SCHEDULER_Tasks & Task) != 0;
+}
+
+void SCHEDULER_ClearTask(uint16_t Task)
+{
+	SCHEDULER_Tasks &= ~Task;
+}
+
+void MOCK_Tick(void)
+{
+	if (gSpecialTimer) {
+		gSpecialTimer--;
+	}
+	if (VOX_Timer) {
+		VOX_Timer--;
+	}
+	if (gIncomingTimer) {
+		gIncomingTimer--;
+	}
+	if (gBatteryTimer) {
+		gBatteryTimer--;
+	}
+	if (gSaveModeTimer) {
+		gSaveModeTimer--;
+	}
+	if (gIdleTimer) {
+		gIdleTimer--;
+	}
+	if (SCANNER_Countdown) {
+		SCANNER_Countdown--;
+	}
+	if (gDetectorTimer) {
+		gDetectorTimer--;
+	}
+	SCHEDULER_Counter++;
+	ENCRYPT_Timer++;
+	STANDBY_Counter++;
+	gTimeSinceBoot++;
+	SCHEDULER_Tasks |= TASK_CHECK_SIDE_KEYS | TASK_CHECK_KEY_PAD | TASK_CHECK_PTT | TASK_SCANNER | TASK_SPECTRUM;
+	if ((SCHEDULER_Counter & 1) == 0) {
+		SCHEDULER_Tasks |= TASK_CHECK_RSSI | TASK_CHECK_INCOMING;
+	}
+}
+
@@ -0,0 +1,87 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <string.h>
+#include "driver/serial-flash.h"
+#include "mock/mock.h"
+#include "radio/frequencies.h"
+
+// Programming only clears bits, like the real part
+uint8_t gMockFlash[MOCK_FLASH_SIZE];
+uint32_t gMockFlashReadBytes;
+
+void MOCK_FLASH_Reset(void)
+{
+	memset(gMockFlash, 0xFF, sizeof(gMockFlash));
+	gMockFlashReadBytes = 0;
+}
+
+// Every band gets a frequency offset of 32768 and squelch levels that change every 500 kHz
+void MOCK_FLASH_WriteBands(void)
+{
+	FrequencyBandInfo_t Info;
+	uint8_t i;
+
+	memset(&Info, 0, sizeof(Info));
+	Info.FrequencyOffset = 32768;
+	for (i = 0; i < 16; i++) {
+		Info.SquelchNoiseWide[i] = 40 + i;
+		Info.SquelchNoiseNarrow[i] = 42 + i;
+		Info.SquelchRSSIWide[i] = 80 + i;
+		Info.SquelchRSSINarrow[i] = 85 + i;
+	}
+	for (i = 0; i < 8; i++) {
+		memcpy(&gMockFlash[0x3BF020 + (i * sizeof(Info))], &Info, sizeof(Info));
+	}
+}
+
+void MOCK_FLASH_WriteChannel(uint16_t Channel, const ChannelInfo_t *pChannel)
+{
+	memcpy(&gMockFlash[0x3C2000 + (Channel * sizeof(*pChannel))], pChannel, sizeof(*pChannel));
+}
+
+void SFLASH_Init(void)
+{
+}
+
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	gMockFlashReadBytes += Size;
+	memcpy(pBuffer, &gMockFlash[Address % MOCK_FLASH_SIZE], Size);
+}
+
+void SFLASH_Erase(uint32_t Page)
+{
+	memset(&gMockFlash[(Page << 12) % MOCK_FLASH_SIZE], 0xFF, 0x1000);
+}
+
+void SFLASH_Write(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint16_t i;
+
+	for (i = 0; i < Size; i++) {
+		gMockFlash[(Address + i) % MOCK_FLASH_SIZE] &= pBytes[i];
+	}
+}
+
+// Ends the same as the erase and rewrite of the real one
+void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	memcpy(&gMockFlash[Address % MOCK_FLASH_SIZE], pBuffer, Size);
+}
+
@@ -0,0 +1,103 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include "app/fm.h"
+#include "driver/audio.h"
+#include "driver/beep.h"
+#include "driver/key.h"
+#include "driver/speaker.h"
+#include "driver/uart.h"
+#include "helper/dtmf.h"
+#include "helper/helper.h"
+#include "helper/inputbox.h"
+#include "radio/data.h"
+#include "radio/hardware.h"
+#include "task/alarm.h"
+#include "task/keyaction.h"
+#include "task/ptt.h"
+#include "task/screen.h"
+#include "ui/boot.h"
+#include "ui/gfx.h"
+#include "ui/helper.h"
+#include "ui/main.h"
+#include "ui/vfo.h"
+
+// Whatever the units under test call outside of the radio: the display, audio, FM, DTMF and
+// the keys. None of it has a say in what gets tuned or when.
+
+uint16_t COLOR_BACKGROUND;
+uint16_t COLOR_FOREGROUND;
+uint16_t COLOR_RED;
+
+DTMF_String_t gDTMF_Contacts[16];
+DTMF_String_t gDTMF_Input;
+DTMF_String_t gDTMF_Kill;
+DTMF_Settings_t gDTMF_Settings;
+DTMF_String_t gDTMF_Stun;
+DTMF_String_t gDTMF_Wake;
+
+FM_Mode_t gFM_Mode;
+
+char gInputBox[8];
+uint8_t gInputBoxWriteIndex;
+
+uint16_t KEY_KeyCounter;
+uint16_t KEY_Side1Counter;
+uint16_t KEY_Side2Counter;
+
+void ALARM_Stop(void) {}
+void AUDIO_PlayChannelNumber(void) {}
+void AUDIO_PlaySampleOptional(uint8_t Index) {}
+void BEEP_Disable(void) {}
+void BEEP_Enable(void) {}
+void DATA_SendDeviceName(void) {}
+bool DATA_WasDataReceived(void) { return false; }
+void DISPLAY_Fill(uint8_t X0, uint8_t X1, uint8_t Y0, uint8_t Y1, uint16_t Color) {}
+void DTMF_ClearString(void) {}
+void DTMF_Disable(void) {}
+void DTMF_FSK_InitReceive(uint8_t Unused) {}
+void DTMF_PlayContact(const DTMF_String_t *pContact) {}
+void DTMF_ResetString(void) {}
+void FM_Disable(bool bStandby) {}
+void FM_Play(void) {}
+void FM_Resume(void) {}
+void HARDWARE_EnableInterrupts(bool bEnable) {}
+void HARDWARE_Reboot(void) {}
+void INPUTBOX_Pad(uint8_t i, char c) {}
+KEY_t KEY_GetButton(void) { return KEY_NONE; }
+void PTT_ClearLock(uint8_t Flags) {}
+void PTT_SetLock(uint8_t Flags) {}
+void SCREEN_TurnOn(void) {}
+void SPEAKER_TurnOff(uint8_t Owner) {}
+void SPEAKER_TurnOn(uint8_t Owner) {}
+void SetDefaultKeyShortcuts(uint8_t IncludeSideKeys) {}
+void Task_UpdateScreen(void) {}
+void UART_Init(uint32_t BaudRate) {}
+void UI_DrawBoot(void) {}
+void UI_DrawDTMF(void) {}
+void UI_DrawFMFrequency(uint16_t Frequency) {}
+void UI_DrawFrequency(uint32_t Frequency, uint8_t Vfo, uint16_t Color) {}
+void UI_DrawMain(bool bSkipStatus) {}
+void UI_DrawMainBitmap(bool bOverride, uint8_t Vfo) {}
+void UI_DrawRX(uint8_t Vfo) {}
+void UI_DrawScan(void) {}
+void UI_DrawScanRate(uint8_t Rate) {}
+void UI_DrawSomething(void) {}
+void UI_DrawVfo(uint8_t Vfo) {}
+void UI_DrawVoltage(uint8_t Vfo) {}
+void UI_SetColors(uint8_t DarkMode) {}
+
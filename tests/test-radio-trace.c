@@ -0,0 +1,184 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "app/css.h"
+#include "app/radio.h"
+#include "misc.h"
+#include "mock/mock.h"
+#include "radio/channels.h"
+#include "radio/settings.h"
+
+// Every hop between two channels of the set is made twice from the same state: with
+// RADIO_Tune() and with the RADIO_ScanTune() replay. Both must leave the BK4819 registers the
+// same, and the replay may only write registers the full tune writes too.
+
+typedef struct {
+	uint32_t Frequency;
+	uint8_t CodeType;
+	uint16_t Code;
+	bool bIsNarrow;
+	uint8_t Modulation;
+	bool bMuteEnabled;
+} TestChannel_t;
+
+static const TestChannel_t Channels[] = {
+	{ 14500000, CODE_TYPE_OFF,   0,  false, 0, false },
+	{ 14501250, CODE_TYPE_CTCSS, 8,  true,  0, false },
+	{ 14550000, CODE_TYPE_DCS_N, 20, false, 0, false },
+	{ 14600000, CODE_TYPE_OFF,   0,  false, 1, false },	// AM keeps the filter bandwidth
+	{ 14480000, CODE_TYPE_OFF,   0,  false, 0, true },	// custom code
+	{ 14650000, CODE_TYPE_DCS_I, 5,  true,  0, false },
+	{ 43500000, CODE_TYPE_CTCSS, 12, true,  0, false },	// other band, no replay
+};
+
+#define CHANNEL_COUNT	(sizeof(Channels) / sizeof(Channels[0]))
+
+#define CHECK(x)	Check((x), #x, __LINE__)
+
+static uint16_t Failures;
+static uint16_t Checks;
+
+static void Check(bool bPassed, const char *pText, int Line)
+{
+	Checks++;
+	if (!bPassed) {
+		Failures++;
+		printf("test-radio-trace.c:%d: %s failed\n", Line, pText);
+	}
+}
+
+static void SetupFlash(void)
+{
+	ChannelInfo_t Channel;
+	uint16_t i;
+
+	MOCK_FLASH_Reset();
+	MOCK_FLASH_WriteBands();
+	for (i = 0; i < CHANNEL_COUNT; i++) {
+		memset(&Channel, 0, sizeof(Channel));
+		Channel.RX.Frequency = Channels[i].Frequency;
+		Channel.RX.CodeType = Channels[i].CodeType;
+		Channel.RX.Code = Channels[i].Code;
+		Channel.TX = Channel.RX;
+		Channel.gModulationType = Channels[i].Modulation;
+		Channel.bIsNarrow = Channels[i].bIsNarrow;
+		Channel.bMuteEnabled = Channels[i].bMuteEnabled;
+		Channel.bIs24Bit = 1;
+		Channel.Golay = 0x123456;
+		Channel.IsInscanList = 0x01;
+		Channel.Name[0] = 'A' + i;
+		MOCK_FLASH_WriteChannel(i, &Channel);
+	}
+}
+
+static void Tune(uint16_t Channel, bool bFast)
+{
+	gSettings.VfoChNo[0] = Channel;
+	CHANNELS_LoadChannel(Channel, 0);
+	if (bFast) {
+		RADIO_ScanTune(0);
+	} else {
+		RADIO_Tune(0);
+	}
+}
+
+// Returns the number of writes of the hop from From to To and the registers it leaves in pRegisters
+static uint16_t Hop(uint16_t From, uint16_t To, bool bFast, uint16_t *pRegisters, uint8_t *pWritten)
+{
+	const MOCK_Write_t *pTrace;
+	uint16_t Count;
+	uint16_t i;
+
+	Tune(From, false);
+	MOCK_BK4819_StartTrace();
+	Tune(To, bFast);
+	Count = MOCK_BK4819_GetTrace(&pTrace);
+	memcpy(pRegisters, gMockRegisters, sizeof(gMockRegisters));
+	memset(pWritten, 0, 128);
+	for (i = 0; i < Count; i++) {
+		pWritten[pTrace[i].Reg & 0x7FU] = 1;
+	}
+
+	return Count;
+}
+
+int main(void)
+{
+	uint16_t SlowRegisters[128];
+	uint16_t FastRegisters[128];
+	uint8_t SlowWritten[128];
+	uint8_t FastWritten[128];
+	uint32_t SlowWrites = 0;
+	uint32_t FastWrites = 0;
+	uint16_t Hops = 0;
+	bool bSubset;
+	uint16_t From;
+	uint16_t To;
+	uint8_t i;
+
+	SetupFlash();
+	MOCK_BK4819_Reset();
+	memset(&gSettings, 0, sizeof(gSettings));
+	gSettings.WorkMode = 1;
+	gSettings.Squelch = 4;
+	memset(&gExtendedSettings, 0, sizeof(gExtendedSettings));
+	gExtendedSettings.ScanAll = 1;
+	CHANNELS_BuildIndex();
+	gScannerMode = true;
+
+	// The first hop to each channel is a full tune that keeps its descriptor
+	RADIO_ClearScanTunes();
+	for (To = 0; To < CHANNEL_COUNT; To++) {
+		Tune(To, true);
+	}
+
+	for (From = 0; From < CHANNEL_COUNT; From++) {
+		for (To = 0; To < CHANNEL_COUNT; To++) {
+			const uint16_t Slow = Hop(From, To, false, SlowRegisters, SlowWritten);
+			const uint16_t Fast = Hop(From, To, true, FastRegisters, FastWritten);
+
+			if (From == To) {
+				continue;
+			}
+			CHECK(memcmp(SlowRegisters, FastRegisters, sizeof(SlowRegisters)) == 0);
+			bSubset = true;
+			for (i = 0; i < 128; i++) {
+				if (SlowRegisters[i] != FastRegisters[i]) {
+					printf("  %u -> %u: register 0x%02X is 0x%04X after RADIO_Tune(), 0x%04X after RADIO_ScanTune()\n", From, To, i, SlowRegisters[i], FastRegisters[i]);
+				}
+				if (FastWritten[i] && !SlowWritten[i]) {
+					bSubset = false;
+				}
+			}
+			CHECK(bSubset);
+			if (Channels[From].Frequency / 10000000U == Channels[To].Frequency / 10000000U) {
+				CHECK(Fast < Slow);
+				SlowWrites += Slow;
+				FastWrites += Fast;
+				Hops++;
+			}
+		}
+	}
+
+	printf("test-radio-trace: %u hops in a band, %lu writes per RADIO_Tune(), %lu per RADIO_ScanTune()\n",
+		Hops, (unsigned long)(SlowWrites / Hops), (unsigned long)(FastWrites / Hops));
+	printf("test-radio-trace: %u of %u checks passed\n", Checks - Failures, Checks);
+
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,277 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "app/css.h"
+#include "app/radio.h"
+#include "driver/key.h"
+#include "misc.h"
+#include "mock/mock.h"
+#include "radio/channels.h"
+#include "radio/scheduler.h"
+#include "radio/settings.h"
+#include "task/incoming.h"
+#include "task/scanner.h"
+
+// Four channels in scan list 1, the third one gets a carrier. The scanner is run a
+// millisecond at a time with the squelch tasks, so the resume delays come out in ms.
+
+#define CHANNEL_COUNT	4
+#define BUSY_CHANNEL	2
+
+// The timed scan runs this long over the empty channels before the busy one gets its carrier
+#define SCAN_TIME	5000
+
+#define CHECK(x)	Check((x), #x, __LINE__)
+
+static uint16_t Failures;
+static uint16_t Checks;
+static uint16_t LastChannel;
+static uint32_t Hops;
+
+static void Check(bool bPassed, const char *pText, int Line)
+{
+	Checks++;
+	if (!bPassed) {
+		Failures++;
+		printf("test-scanner.c:%d: %s failed\n", Line, pText);
+	}
+}
+
+static uint32_t GetChannelFrequency(uint16_t Channel)
+{
+	return 14500000U + (Channel * 2500U);
+}
+
+static void SetupFlash(void)
+{
+	ChannelInfo_t Channel;
+	uint16_t i;
+
+	MOCK_FLASH_Reset();
+	MOCK_FLASH_WriteBands();
+	for (i = 0; i < CHANNEL_COUNT; i++) {
+		memset(&Channel, 0, sizeof(Channel));
+		Channel.RX.Frequency = GetChannelFrequency(i);
+		Channel.RX.CodeType = CODE_TYPE_OFF;
+		Channel.TX.Frequency = GetChannelFrequency(i);
+		Channel.TX.CodeType = CODE_TYPE_OFF;
+		Channel.IsInscanList = 0x01;
+		Channel.Name[0] = 'A' + i;
+		MOCK_FLASH_WriteChannel(i, &Channel);
+	}
+}
+
+static void StartScan(uint8_t ScanResume)
+{
+	SetupFlash();
+	MOCK_BK4819_Reset();
+
+	memset(&gSettings, 0, sizeof(gSettings));
+	gSettings.WorkMode = 1;
+	gSettings.Squelch = 1;
+	memset(&gExtendedSettings, 0, sizeof(gExtendedSettings));
+	gExtendedSettings.ScanResume = ScanResume;
+	gExtendedSettings.ScanAll = 1;
+	gExtendedSettings.ScanRate = 7 ^ 5;	// 30 ch/s
+	gExtendedSettings.PriorityScanOff = 1;
+	gExtendedSettings.ScanActiveFirstOff = 1;
+	gRadioMode = RADIO_MODE_QUIET;
+	gIncomingTimer = 0;
+
+	CHANNELS_BuildIndex();
+	CHANNELS_LoadChannel(0, 0);
+	RADIO_Tune(0);
+	gScannerMode = true;
+	SCANNER_Countdown = 0;
+	LastChannel = 0;
+	Hops = 0;
+}
+
+// One millisecond of the main loop: Task_CheckRSSI() starts RX as soon as the squelch link
+// has made it INCOMING, there are no tones on the test channels.
+static void Step(void)
+{
+	MOCK_Tick();
+	Task_CheckIncoming();
+	if (gRadioMode == RADIO_MODE_INCOMING && SCHEDULER_CheckTask(TASK_CHECK_RSSI)) {
+		SCHEDULER_ClearTask(TASK_CHECK_RSSI);
+		RADIO_StartRX();
+	}
+	Task_Scanner();
+	if (gSettings.VfoChNo[0] != LastChannel) {
+		LastChannel = gSettings.VfoChNo[0];
+		Hops++;
+	}
+}
+
+static bool IsReceiving(void)
+{
+	return gRadioMode == RADIO_MODE_RX;
+}
+
+static bool HasLeftBusyChannel(void)
+{
+	return gSettings.VfoChNo[0] != BUSY_CHANNEL;
+}
+
+// Returns the ms it took for pCondition to hold, or Limit + 1 if it never did
+static uint32_t RunUntil(bool (*pCondition)(void), uint32_t Limit)
+{
+	uint32_t Time;
+
+	for (Time = 0; Time <= Limit && !pCondition(); Time++) {
+		Step();
+	}
+
+	return Time;
+}
+
+static void Run(uint32_t Time)
+{
+	while (Time--) {
+		Step();
+	}
+}
+
+// Scans onto the busy channel, returns once it receives there
+static void StopOnCarrier(uint8_t ScanResume)
+{
+	StartScan(ScanResume);
+	MOCK_BK4819_SetCarrier(GetChannelFrequency(BUSY_CHANNEL), true);
+	CHECK(RunUntil(IsReceiving, 1000) <= 1000);
+	CHECK(gSettings.VfoChNo[0] == BUSY_CHANNEL);
+	CHECK(MOCK_BK4819_GetFrequency() == GetChannelFrequency(BUSY_CHANNEL));
+}
+
+// Scans the empty channels for SCAN_TIME ms, the first lap excluded as it fills the channel
+// cache, then times the stop on a carrier that comes up on the busy channel.
+static void TestThroughput(void)
+{
+	uint32_t CarrierTime;
+	uint32_t FlashBytes;
+	uint32_t Transactions;
+	uint32_t Rate;
+	uint32_t Latency;
+
+	StartScan(1);
+	CarrierTime = gTimeSinceBoot + SCAN_TIME;
+	MOCK_BK4819_SetCarrierAt(GetChannelFrequency(BUSY_CHANNEL), CarrierTime);
+	Run(1000);
+	Hops = 0;
+	FlashBytes = gMockFlashReadBytes;
+	Transactions = gMockBK4819Transactions;
+	Run(CarrierTime - gTimeSinceBoot);
+	Rate = (Hops * 1000U) / (SCAN_TIME - 1000);
+	FlashBytes = (gMockFlashReadBytes - FlashBytes) / Hops;
+	Transactions = (gMockBK4819Transactions - Transactions) / Hops;
+	RunUntil(IsReceiving, 2000);
+	Latency = gTimeSinceBoot - CarrierTime;
+
+	printf("test-scanner: %lu channels/s, %lu flash bytes and %lu BK4819 transactions per hop, stopped %lu ms after the carrier came up\n",
+		(unsigned long)Rate, (unsigned long)FlashBytes, (unsigned long)Transactions, (unsigned long)Latency);
+	// Empty channels are left once the PLL has settled, not after a dwell
+	CHECK(Rate >= 100);
+	CHECK(FlashBytes == 0);
+	CHECK(Transactions <= 40);
+	CHECK(IsReceiving());
+	CHECK(gSettings.VfoChNo[0] == BUSY_CHANNEL);
+	CHECK(Latency <= 200);
+}
+
+// Stays while the carrier lasts, moves on 3 s after it drops
+static void TestCarrier(void)
+{
+	uint32_t Time;
+
+	StopOnCarrier(1);
+	Run(10000);
+	CHECK(IsReceiving());
+	CHECK(gSettings.VfoChNo[0] == BUSY_CHANNEL);
+
+	MOCK_BK4819_SetCarrier(GetChannelFrequency(BUSY_CHANNEL), false);
+	Time = RunUntil(HasLeftBusyChannel, 5000);
+	CHECK(Time >= 3000 && Time <= 3100);
+	CHECK(gScannerMode);
+	CHECK(!IsReceiving());
+}
+
+// Moves on 5 s after the stop, carrier or not
+static void TestTime(void)
+{
+	uint32_t Time;
+
+	StopOnCarrier(2);
+	Time = RunUntil(HasLeftBusyChannel, 10000);
+	CHECK(Time >= 4990 && Time <= 5010);
+	CHECK(gScannerMode);
+	CHECK(!IsReceiving());
+}
+
+// Scanning ends with the reception, on the busy channel
+static void TestNoResume(void)
+{
+	StopOnCarrier(3);
+	Run(2000);
+	CHECK(IsReceiving());
+
+	MOCK_BK4819_SetCarrier(GetChannelFrequency(BUSY_CHANNEL), false);
+	Run(10000);
+	CHECK(!gScannerMode);
+	CHECK(!IsReceiving());
+	CHECK(gSettings.VfoChNo[0] == BUSY_CHANNEL);
+}
+
+// Changing the scan list rebuilds the list index from RAM, a saved channel moves with its
+// journal entry. Only the channel that is stepped to may be read from the flash.
+static void TestScanLists(void)
+{
+	ChannelInfo_t Channel;
+	uint32_t FlashBytes;
+
+	StartScan(1);
+	gScannerMode = false;
+	CHANNELS_ReadChannel(3, &Channel);
+	Channel.IsInscanList = 0x02;
+	CHANNELS_SaveChannel(3, &Channel);
+
+	gExtendedSettings.CurrentScanList = 1;
+	FlashBytes = gMockFlashReadBytes;
+	CHECK(CHANNELS_NextChannelMr(KEY_UP, true));
+	CHECK(gSettings.VfoChNo[0] == 3);
+	CHECK(gMockFlashReadBytes - FlashBytes <= sizeof(ChannelInfo_t));
+
+	gExtendedSettings.CurrentScanList = 0;
+	FlashBytes = gMockFlashReadBytes;
+	CHECK(CHANNELS_NextChannelMr(KEY_UP, true));
+	CHECK(gSettings.VfoChNo[0] == 0);
+	CHECK(gMockFlashReadBytes - FlashBytes <= sizeof(ChannelInfo_t));
+}
+
+int main(void)
+{
+	TestThroughput();
+	TestScanLists();
+	TestCarrier();
+	TestTime();
+	TestNoResume();
+
+	printf("test-scanner: %u of %u checks passed\n", Checks - Failures, Checks);
+
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app/smooth.h"
+
+// SMOOTH_TraceDsp() is app/smooth.c built with SMOOTH_DSP, the packed pair __SMLAD path, against
+// the C models of mock/dsp.h. Both paths must give the same trace for samples up to 0x7FFF, the
+// DSP multiplies are signed. The cycles are measured on the radio, see UART_DEBUG in app/spectrum.c.
+
+#define TRACE_SIZE	160
+#define TRACE_COUNT	1000
+
+void SMOOTH_TraceDsp(uint16_t *pPixels, uint8_t Count);
+
+#define CHECK(x)	Check((x), #x, __LINE__)
+
+static uint16_t Failures;
+static uint16_t Checks;
+
+static void Check(bool bPassed, const char *pText, int Line)
+{
+	Checks++;
+	if (!bPassed) {
+		Failures++;
+		printf("test-smooth.c:%d: %s failed\n", Line, pText);
+	}
+}
+
+static void Fill(uint16_t *pPixels, uint16_t Max)
+{
+	uint8_t i;
+
+	for (i = 0; i < TRACE_SIZE; i++) {
+		pPixels[i] = rand() % (Max + 1U);
+	}
+}
+
+// Plain 5-point convolution with the edges extended, nothing slid or packed
+static void Smooth(const uint16_t *pIn, uint16_t *pOut, uint8_t Count)
+{
+	uint8_t i;
+
+	for (i = 0; i < Count; i++) {
+		const uint32_t Far0 = pIn[i > 1 ? i - 2 : 0];
+		const uint32_t Near0 = pIn[i > 0 ? i - 1 : 0];
+		const uint32_t Near1 = pIn[i + 1 < Count ? i + 1 : Count - 1];
+		const uint32_t Far1 = pIn[i + 2 < Count ? i + 2 : Count - 1];
+		const uint32_t Sum = (pIn[i] * SMOOTH_WEIGHT_CENTER) + ((Near0 + Near1) * SMOOTH_WEIGHT_NEAR) + ((Far0 + Far1) * SMOOTH_WEIGHT_FAR);
+
+		pOut[i] = (Sum + 128) >> 8;
+	}
+}
+
+static void CheckTrace(const uint16_t *pPixels, uint8_t Count)
+{
+	uint16_t Expected[TRACE_SIZE];
+	uint16_t C[TRACE_SIZE];
+	uint16_t Dsp[TRACE_SIZE];
+
+	Smooth(pPixels, Expected, Count);
+	memcpy(C, pPixels, Count * sizeof(C[0]));
+	memcpy(Dsp, pPixels, Count * sizeof(Dsp[0]));
+	SMOOTH_Trace(C, Count);
+	SMOOTH_TraceDsp(Dsp, Count);
+	CHECK(memcmp(C, Expected, Count * sizeof(C[0])) == 0);
+	CHECK(memcmp(Dsp, Expected, Count * sizeof(Dsp[0])) == 0);
+}
+
+int main(void)
+{
+	uint16_t Pixels[TRACE_SIZE];
+	uint16_t i;
+
+	srand(1);
+	for (i = 0; i < TRACE_COUNT; i++) {
+		Fill(Pixels, i & 1 ? 0x1FF : 0x7FFF);
+		CheckTrace(Pixels, TRACE_SIZE);
+	}
+
+	// Flat traces stay flat, the extremes included
+	for (i = 0; i < TRACE_SIZE; i++) {
+		Pixels[i] = 0x7FFF;
+	}
+	CheckTrace(Pixels, TRACE_SIZE);
+	memset(Pixels, 0, sizeof(Pixels));
+	CheckTrace(Pixels, TRACE_SIZE);
+	Pixels[TRACE_SIZE / 2] = 0x7FFF;
+	CheckTrace(Pixels, TRACE_SIZE);
+
+	// The shortest trace still reads 3 samples, odd lengths end on a single sample and an odd
+	// start is not word aligned
+	for (i = 3; i < 8; i++) {
+		Fill(Pixels, 0x7FFF);
+		CheckTrace(Pixels, i);
+		CheckTrace(Pixels + 1, i);
+	}
+	Fill(Pixels, 0x7FFF);
+	CheckTrace(Pixels + 1, TRACE_SIZE - 1);
+
+	printf("test-smooth: %u of %u checks passed\n", Checks - Failures, Checks);
+
+	return Failures ? 1 : 0;
+}
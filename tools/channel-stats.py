@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dual Tachyon
+# https://github.com/DualTachyon
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+
+"""Download the per-channel receive statistics.
+
+    channel-stats.py /dev/ttyUSB0
+
+The statistics are read from RAM with UART command 0x56, so receptions that
+have not been flushed to the SPI flash yet are included.
+"""
+
+import argparse
+import struct
+import sys
+
+from radio_uart import BLOCK_SIZE, add_port_arguments, open_port, read_block, format_clock
+
+LOG_SIZE = 256
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+	add_port_arguments(parser)
+	args = parser.parse_args()
+
+	port = open_port(args)
+	data = b''.join(read_block(port, 0x56, i) for i in range(LOG_SIZE // BLOCK_SIZE))
+
+	magic, sequence, clock, count = struct.unpack_from('<IIIB', data, 0)
+	if magic != 0x31545343:
+		sys.exit('No channel statistics')
+
+	entries = [struct.unpack_from('<HHII', data, 16 + i * 12) for i in range(count)]
+	entries.sort(key=lambda e: (e[1], e[2]), reverse=True)
+
+	print('Last flush at radio clock %s, %d flushes so far' % (format_clock(clock), sequence))
+	print('Channel   Hits  RX time          Last heard')
+	for channel, hits, rx_time, last in entries:
+		print('CH-%03d  %6d %s %s' % (channel + 1, hits, format_clock(rx_time), format_clock(last)))
+
+
+if __name__ == '__main__':
+	main()
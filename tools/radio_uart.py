@@ -0,0 +1,52 @@
+# Copyright 2023 Dual Tachyon
+# https://github.com/DualTachyon
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+
+"""Serial port helpers shared by the tools in this directory.
+
+Block reads use the 4 byte requests of UART commands 0x52 to 0x57: command,
+block number high and low byte and their sum. The reply echoes the first 3
+bytes, carries 128 data bytes and ends with the sum of everything before it.
+"""
+
+import sys
+
+try:
+	import serial
+except ImportError:
+	sys.exit('pyserial is required: pip install pyserial')
+
+BLOCK_SIZE = 128
+
+
+def add_port_arguments(parser):
+	parser.add_argument('port')
+	parser.add_argument('-b', '--baud', type=int, default=115200)
+
+
+def open_port(args):
+	return serial.Serial(args.port, args.baud, timeout=1)
+
+
+def read_block(port, command, block):
+	request = bytes([command, block >> 8, block & 0xFF])
+	port.write(request + bytes([sum(request) & 0xFF]))
+	reply = port.read(BLOCK_SIZE + 4)
+	if len(reply) != BLOCK_SIZE + 4 or reply[:3] != request or sum(reply[:-1]) & 0xFF != reply[-1]:
+		sys.exit('Bad reply for block %d' % block)
+	return reply[3:-1]
+
+
+def format_clock(seconds):
+	return '%3dd %02d:%02d:%02d' % (seconds // 86400, seconds // 3600 % 24, seconds // 60 % 60, seconds % 60)
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dual Tachyon
+# https://github.com/DualTachyon
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+
+"""Download the scanner stop log.
+
+    scan-log.py /dev/ttyUSB0
+
+The log is read with UART command 0x57 while the radio keeps scanning. The
+page being filled is read from RAM, so stops that have not been flushed to
+the SPI flash yet are included. Stops are printed oldest first.
+"""
+
+import argparse
+import struct
+import sys
+
+from radio_uart import BLOCK_SIZE, add_port_arguments, open_port, read_block, format_clock
+
+LOG_MAGIC = 0x31474C53
+LOG_PAGES = 64
+PAGE_SIZE = 256
+RECORD_SIZE = 16
+REASONS = ('carrier', 'time', 'forced', 'lockout', 'priority', 'stopped')
+
+
+def format_code(code_type, code):
+	if code_type == 0:
+		return '%5.1f' % (code / 10.0)
+	if code_type in (1, 2):
+		return 'D%03o%s' % (code & 0x1FF, 'N' if code_type == 1 else 'I')
+	return '  OFF'
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+	add_port_arguments(parser)
+	args = parser.parse_args()
+
+	port = open_port(args)
+
+	# Pages without the magic are erased, their second half is not read.
+	pages = []
+	for page in range(LOG_PAGES):
+		data = read_block(port, 0x57, page * 2)
+		magic, sequence = struct.unpack_from('<II', data, 0)
+		if magic == LOG_MAGIC:
+			pages.append((sequence, data + read_block(port, 0x57, page * 2 + 1)))
+	if not pages:
+		sys.exit('No scan log')
+	pages.sort()
+
+	print('Radio clock       Frequency    Channel  CSS    RSSI  Duration  Resume')
+	for sequence, data in pages:
+		for offset in range(16, PAGE_SIZE, RECORD_SIZE):
+			time, frequency, channel, duration, code, rssi, reason = struct.unpack_from('<IIHHHBB', data, offset)
+			# The current page can grow between its two blocks, so a free record is not the end
+			if time == 0xFFFFFFFF:
+				continue
+			print('%s %10.5f MHz  %-7s %s %4d dBm %7.1fs  %s' % (
+				format_clock(time), frequency / 100000.0,
+				'VFO' if channel == 0xFFFF else 'CH-%03d' % (channel + 1),
+				format_code(code >> 12, code & 0xFFF), rssi - 160, duration / 10.0,
+				REASONS[reason] if reason < len(REASONS) else reason))
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dual Tachyon
+# https://github.com/DualTachyon
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+
+"""List and download the spectrum snapshots stored in the SPI flash.
+
+    spectrum-snapshot.py /dev/ttyUSB0              list the snapshots
+    spectrum-snapshot.py /dev/ttyUSB0 3 > 3.csv    download snapshot 3
+
+A snapshot is taken with any side key while the spectrum is open. The
+snapshots are read with UART command 0x54, a download is printed as CSV
+with one line per bin.
+"""
+
+import argparse
+import struct
+import sys
+
+from radio_uart import BLOCK_SIZE, add_port_arguments, open_port, read_block, format_clock
+
+SLOTS = 16
+SLOT_SIZE = 512
+HEADER = struct.Struct('<IIIIIHHBBBB4x')
+MAGIC = 0x31535053
+MODULATIONS = ('FM', 'AM', 'SB')
+
+
+def read_header(port, slot):
+	data = read_block(port, 0x54, slot * (SLOT_SIZE // BLOCK_SIZE))
+	header = HEADER.unpack_from(data, 0)
+	if header[0] != MAGIC:
+		return None
+	return header
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+	add_port_arguments(parser)
+	parser.add_argument('slot', nargs='?', type=int, help='snapshot to download, 1 to %d' % SLOTS)
+	args = parser.parse_args()
+
+	port = open_port(args)
+
+	if args.slot is None:
+		headers = [(slot, read_header(port, slot)) for slot in range(SLOTS)]
+		headers = sorted((h for h in headers if h[1]), key=lambda h: h[1][1], reverse=True)
+		print('Slot  Seq     Radio clock        Start MHz    Step kHz  Bins  Mode')
+		for slot, (magic, sequence, clock, start, step, delay, squelch, count, modulation, narrow, waterfall) in headers:
+			print('%4d %4d %s %12.5f %10.2f %5d  %s%s %s' % (
+				slot + 1, sequence, format_clock(clock), start / 100000.0, step / 100.0, count,
+				MODULATIONS[modulation % 3], 'N' if narrow else 'W', 'waterfall' if waterfall else 'spectrum'))
+		return
+
+	slot = args.slot - 1
+	if slot < 0 or slot >= SLOTS:
+		sys.exit('Slot must be 1 to %d' % SLOTS)
+	first = slot * (SLOT_SIZE // BLOCK_SIZE)
+	data = b''.join(read_block(port, 0x54, first + i) for i in range(SLOT_SIZE // BLOCK_SIZE))
+	magic, sequence, clock, start, step, delay, squelch, count, modulation, narrow, waterfall = HEADER.unpack_from(data, 0)
+	if magic != MAGIC:
+		sys.exit('Slot %d is empty' % args.slot)
+
+	rssi = struct.unpack_from('<%dH' % count, data, HEADER.size)
+	print('# snapshot %d, radio clock %s, squelch %d dBm' % (sequence, format_clock(clock).strip(), squelch // 2 - 160))
+	print('frequency_mhz,rssi_dbm')
+	for i, value in enumerate(rssi):
+		print('%.5f,%.1f' % ((start + step * i) / 100000.0, value / 2.0 - 160))
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dual Tachyon
+# https://github.com/DualTachyon
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+
+"""Decode the spectrum sweep frames streamed over the programming cable.
+
+Enable streaming with key 8 while the spectrum is open, then run:
+
+    spectrum-stream.py /dev/ttyUSB0
+
+Each valid frame prints its sequence number, range and peak. Sync losses,
+checksum errors and skipped sequence numbers are counted and reported
+together with the frame rate once per second.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+from radio_uart import add_port_arguments, open_port
+
+SYNC = b'\xAA\x55'
+HEADER_SIZE = 12
+
+
+def read_exact(port, size):
+	data = b''
+	while len(data) < size:
+		chunk = port.read(size - len(data))
+		if not chunk:
+			return None
+		data += chunk
+	return data
+
+
+def find_sync(port):
+	skipped = 0
+	last = b''
+	while True:
+		byte = port.read(1)
+		if not byte:
+			continue
+		if last + byte == SYNC:
+			return skipped
+		if last:
+			skipped += 1
+		last = byte
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+	add_port_arguments(parser)
+	parser.add_argument('-q', '--quiet', action='store_true', help='only print the statistics')
+	args = parser.parse_args()
+
+	port = open_port(args)
+
+	frames = 0
+	bad_sum = 0
+	lost = 0
+	resyncs = 0
+	sequence = None
+	window_start = time.monotonic()
+	window_frames = 0
+
+	while True:
+		if find_sync(port):
+			resyncs += 1
+
+		header = read_exact(port, HEADER_SIZE - len(SYNC))
+		if header is None:
+			continue
+		seq, count, start, step = struct.unpack('<BBII', header)
+		body = read_exact(port, count + 1)
+		if body is None:
+			continue
+
+		if sum(header + body[:-1]) & 0xFF != body[-1]:
+			bad_sum += 1
+			continue
+
+		if sequence is not None:
+			lost += (seq - sequence - 1) & 0xFF
+		sequence = seq
+		frames += 1
+		window_frames += 1
+
+		if not args.quiet:
+			rssi = body[:-1]
+			peak = max(range(count), key=lambda i: rssi[i])
+			print('#%3d %4d bins %10.5f-%10.5f MHz peak %10.5f MHz %4d dBm' % (
+				seq, count,
+				start / 100000.0, (start + step * (count - 1)) / 100000.0,
+				(start + step * peak) / 100000.0, rssi[peak] - 160))
+
+		now = time.monotonic()
+		if now - window_start >= 1.0:
+			print('%.1f sweeps/s, %d frames, %d lost, %d bad checksums, %d resyncs' % (
+				window_frames / (now - window_start), frames, lost, bad_sum, resyncs),
+				file=sys.stderr)
+			window_start = now
+			window_frames = 0
+
+
+if __name__ == '__main__':
+	try:
+		main()
+	except KeyboardInterrupt:
+		pass
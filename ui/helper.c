@@ -24,11 +24,13 @@
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "misc.h"
+#include "radio/channels.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "ui/font.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
+#include "ui/main.h"
 #include "ui/vfo.h"
 
 static const uint8_t FontSmall[47][5] = {
@@ -953,9 +955,11 @@ void UI_DrawScan(void)
 	UI_DrawStatusIcon(4, ICON_SCAN, gScannerMode, gColorForeground);
 	if (!gScannerMode) {
 		UI_DrawSmallString(18, 86, " ", 1);
+		UI_DrawBattery(!gSettings.RepeaterMode);
 	} else {
 		if (gSettings.WorkMode) {
 			UI_DrawSmallString(18, 86, gExtendedSettings.ScanAll ? "A" :
+									   CHANNELS_IsScanMerged() ? "M" :
 									   gExtendedSettings.CurrentScanList == 0 ? "1" :
 									   gExtendedSettings.CurrentScanList == 1 ? "2" :
 									   gExtendedSettings.CurrentScanList == 2 ? "3" :
@@ -89,6 +89,21 @@ void UI_DrawRepeaterMode(void)
 	}
 }
 
+void UI_DrawScanRate(uint8_t Rate)
+{
+	if (gSettings.RepeaterMode) {
+		return;
+	}
+	gColorForeground = COLOR_FOREGROUND;
+	Int2Ascii(Rate, 2);
+	if (gShortString[0] == '0') {
+		gShortString[0] = ' ';
+	}
+	gShortString[2] = '/';
+	gShortString[3] = 'S';
+	UI_DrawSmallString(109, 86, gShortString, 4);
+}
+
 void UI_DrawBattery(bool bDisplayVoltage)
 {
 	uint8_t i;
@@ -109,8 +124,8 @@ void UI_DrawBattery(bool bDisplayVoltage)
 	DISPLAY_DrawRectangle0(142, 86, 15 - i, 8, gColorBackground);
 	DISPLAY_DrawRectangle0(157 - i, 86, i, 8, Color);
 
-	// Battery voltage
-	if (bDisplayVoltage){
+	// Battery voltage, the slot shows the scan rate while scanning
+	if (bDisplayVoltage && !gScannerMode){
 		UI_DrawStatusIcon(109, ICON_RR, false, 0);	// Clear Repeater icon
 		gColorForeground = COLOR_FOREGROUND;
 		Int2Ascii(gBatteryVoltage, 2);
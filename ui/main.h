@@ -23,6 +23,7 @@
 void DrawStatusBar(void);
 void UI_DrawMain(bool bSkipStatus);
 void UI_DrawRepeaterMode(void);
+void UI_DrawScanRate(uint8_t Rate);
 void UI_DrawBattery(bool bDisplayVoltage);
 
 #endif
@@ -177,7 +177,13 @@ void UI_DrawActions(uint8_t Index)
 #else
 		"[DISABLED]  ",
 #endif
-		"Dark Mode   "
+		"Dark Mode   ",
+		"Find Channel",
+#ifdef ENABLE_SPECTRUM
+		"Snapshot    ",
+#else
+		"[DISABLED]  ",
+#endif
 	};
 
 	UI_DrawSettingOptionEx(Actions[Index], 12, 0);
@@ -464,20 +470,73 @@ void UI_DrawSettingScanResume(uint8_t Index)
 	UI_DrawSettingOption(Mode[(Index + 1) % 3], 1);
 }
 
-void UI_DrawSettingScanlist(uint8_t Index)
+void UI_DrawSettingScanRate(uint8_t Index)
+{
+	static const char Mode[8][8] = {
+			" 4 ch/s",
+			" 6 ch/s",
+			" 8 ch/s",
+			"10 ch/s",
+			"15 ch/s",
+			"20 ch/s",
+			"25 ch/s",
+			"30 ch/s",
+	};
+
+	UI_DrawSettingOptionEx(Mode[Index], 7, 0);
+	UI_DrawSettingOptionEx(Mode[(Index + 1) % 8], 7, 1);
+}
+
+void UI_DrawSettingLockoutTime(uint8_t Index)
+{
+	static const char Mode[8][7] = {
+			" 1 min",
+			" 5 min",
+			"15 min",
+			"30 min",
+			" 1 h  ",
+			" 2 h  ",
+			" 4 h  ",
+			"Always",
+	};
+
+	UI_DrawSettingOptionEx(Mode[Index], 6, 0);
+	UI_DrawSettingOptionEx(Mode[(Index + 1) % 8], 6, 1);
+}
+
+// Dual watch time on the home VFO / on the other VFO, in ms
+void UI_DrawSettingWatchTime(uint8_t Index)
 {
-	static const char Mode[9][1] = {
-			"1",
-			"2",
-			"3",
-			"4",
-			"5",
-			"6",
-			"7",
-			"8",
-			"*",
+	static const char Mode[8][7] = {
+			" 50/50 ",
+			"100/50 ",
+			"100/100",
+			"200/50 ",
+			"200/100",
+			"300/100",
+			"500/100",
+			"150/150",
 	};
 
-	UI_DrawSettingOptionEx(Mode[Index], 1, 0);
-	UI_DrawSettingOptionEx(Mode[(Index + 1) % 9], 1, 1);
+	UI_DrawSettingOptionEx(Mode[Index], 7, 0);
+	UI_DrawSettingOptionEx(Mode[(Index + 1) % 8], 7, 1);
+}
+
+// Lists 1 to 8, all channels (*) and the merged lists (M followed by the numbers in Lists).
+static void DrawScanlistOption(uint8_t Index, uint8_t Lists, uint8_t Row)
+{
+	char String[9];
+	uint8_t i;
+
+	String[0] = (Index == 8) ? '*' : (Index == 9) ? 'M' : '1' + Index;
+	for (i = 0; i < 8; i++) {
+		String[1 + i] = (Index == 9 && ((Lists >> i) & 1)) ? '1' + i : ' ';
+	}
+	UI_DrawSettingOptionEx(String, sizeof(String), Row);
+}
+
+void UI_DrawSettingScanlist(uint8_t Index, uint8_t Lists)
+{
+	DrawScanlistOption(Index, Lists, 0);
+	DrawScanlistOption((Index + 1) % 10, Lists, 1);
 }
@@ -47,8 +47,11 @@ void UI_DrawSettingTxPower(void);
 void UI_DrawSettingModulation(uint8_t Index);
 void UI_DrawSettingBandwidth(void);
 void UI_DrawSettingBusyLock(uint8_t Index);
-void UI_DrawSettingScanlist(uint8_t Index);
+void UI_DrawSettingScanlist(uint8_t Index, uint8_t Lists);
 void UI_DrawSettingScanResume(uint8_t Index);
+void UI_DrawSettingScanRate(uint8_t Index);
+void UI_DrawSettingLockoutTime(uint8_t Index);
+void UI_DrawSettingWatchTime(uint8_t Index);
 
 #endif
 